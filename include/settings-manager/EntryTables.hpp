@@ -0,0 +1,143 @@
+#pragma once
+
+#include "settings-manager/SettingsEntry.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+namespace settings
+{
+
+/// Structure of arrays copy of an entry array, generated at compile time. Runtime accesses to the
+/// static settings content go through these tables: bounds checks and hash lookups touch dense
+/// arrays instead of strided SettingsEntry objects, and all names are packed into one pool.
+/// The entry array itself is then only used at compile time and not kept in flash, unless
+/// SettingsContainer::getAllSettings() is called.
+///
+/// Bounds and defaults are kept as raw values, see ValueLayout: float bits for real settings,
+/// int32_t bits for integer settings and 0 / 1 for boolean settings.
+/// @tparam SettingsCount
+/// @tparam entryArray
+template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray>
+class EntryTables
+{
+public:
+    using Raw_t = uint32_t;
+
+    [[nodiscard]] static constexpr size_t countNameCharacters()
+    {
+        size_t count = 0;
+        for (const auto &entry : entryArray)
+        {
+            count += entry.name.size();
+        }
+        return count;
+    }
+
+    static constexpr size_t NamePoolSize = countNameCharacters();
+    using NameOffset_t = std::conditional_t<(NamePoolSize <= std::numeric_limits<uint16_t>::max()),
+                                            uint16_t, uint32_t>;
+
+    [[nodiscard]] static constexpr VariableType getVariableType(size_t index)
+    {
+        return static_cast<VariableType>(Tables.types[index]);
+    }
+
+    [[nodiscard]] static constexpr uint64_t getNameHash(size_t index)
+    {
+        return Tables.hashes[index];
+    }
+
+    [[nodiscard]] static constexpr std::string_view getName(size_t index)
+    {
+        return std::string_view{Tables.names.data() + Tables.nameOffsets[index],
+                                static_cast<size_t>(Tables.nameOffsets[index + 1] -
+                                                    Tables.nameOffsets[index])};
+    }
+
+    [[nodiscard]] static constexpr bool hasSameName(size_t index, const std::string_view &name)
+    {
+        return getName(index).compare(name) == 0;
+    }
+
+    [[nodiscard]] static constexpr Raw_t getMinRaw(size_t index)
+    {
+        return Tables.minRaws[index];
+    }
+
+    [[nodiscard]] static constexpr Raw_t getDefaultRaw(size_t index)
+    {
+        return Tables.defaultRaws[index];
+    }
+
+    [[nodiscard]] static constexpr Raw_t getMaxRaw(size_t index)
+    {
+        return Tables.maxRaws[index];
+    }
+
+    /// Bound or default as generic value, integer settings return their exact integer bounds.
+    [[nodiscard]] static constexpr SettingsValue_t toValue(size_t index, Raw_t raw)
+    {
+        if (getVariableType(index) == VariableType::realType)
+        {
+            return __builtin_bit_cast(SettingsValue_t, raw);
+        }
+        return static_cast<SettingsValue_t>(static_cast<int32_t>(raw));
+    }
+
+private:
+    struct TableSet
+    {
+        std::array<Raw_t, SettingsCount> minRaws{};
+        std::array<Raw_t, SettingsCount> defaultRaws{};
+        std::array<Raw_t, SettingsCount> maxRaws{};
+        std::array<uint64_t, SettingsCount> hashes{};
+        std::array<uint8_t, SettingsCount> types{};
+        std::array<NameOffset_t, SettingsCount + 1> nameOffsets{};
+        std::array<char, NamePoolSize == 0 ? 1 : NamePoolSize> names{};
+    };
+
+    [[nodiscard]] static constexpr Raw_t toRaw(const SettingsEntry &entry,
+                                               const SettingsValue_t value, const int32_t integer)
+    {
+        switch (entry.variableType)
+        {
+        case VariableType::integerType:
+            return static_cast<Raw_t>(integer);
+        case VariableType::booleanType:
+            return integer != 0 ? 1 : 0;
+        default:
+            return __builtin_bit_cast(Raw_t, value);
+        }
+    }
+
+    [[nodiscard]] static constexpr TableSet build()
+    {
+        TableSet tables{};
+        size_t nameOffset = 0;
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            const SettingsEntry &Entry = entryArray[i];
+            tables.minRaws[i] = toRaw(Entry, Entry.minValue, Entry.minInteger);
+            tables.defaultRaws[i] = toRaw(Entry, Entry.defaultValue, Entry.defaultInteger);
+            tables.maxRaws[i] = toRaw(Entry, Entry.maxValue, Entry.maxInteger);
+            tables.hashes[i] = Entry.NameHash;
+            tables.types[i] = static_cast<uint8_t>(Entry.variableType);
+            tables.nameOffsets[i] = static_cast<NameOffset_t>(nameOffset);
+            for (const char Character : Entry.name)
+            {
+                tables.names[nameOffset++] = Character;
+            }
+        }
+        tables.nameOffsets[SettingsCount] = static_cast<NameOffset_t>(nameOffset);
+        return tables;
+    }
+
+    static constexpr TableSet Tables = build();
+};
+
+} // namespace settings
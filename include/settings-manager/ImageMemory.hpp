@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <core/SafeAssert.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace settings
+{
+
+/// EEPROM image in RAM, the memory of a SettingsIO on a host, e.g. to inspect dumps of field
+/// units or to create images for flashing. Same size and page size as the target EEPROM, so
+/// slots and migrations are laid out like on the target.
+/// @tparam SizeInBytes size of the EEPROM
+/// @tparam PageSizeInBytes page size of the EEPROM
+template <size_t SizeInBytes, size_t PageSizeInBytes>
+class ImageMemory
+{
+public:
+    ImageMemory()
+    {
+        erase();
+    }
+
+    static constexpr size_t getSizeInBytes()
+    {
+        return SizeInBytes;
+    }
+
+    static constexpr size_t getPageSize()
+    {
+        return PageSizeInBytes;
+    }
+
+    void read(size_t address, uint8_t *buffer, size_t length) const
+    {
+        SafeAssert(address + length <= SizeInBytes);
+        std::memcpy(buffer, bytes.data() + address, length);
+    }
+
+    void write(size_t address, const uint8_t *data, size_t length)
+    {
+        SafeAssert(address + length <= SizeInBytes);
+        std::memcpy(bytes.data() + address, data, length);
+    }
+
+    /// Erased like a new EEPROM.
+    void erase()
+    {
+        bytes.fill(0xFF);
+    }
+
+    /// Replaces the image by a dump, a shorter one is padded with erased bytes.
+    /// @return false if the dump is bigger than the memory, nothing is assigned then
+    bool assign(const uint8_t *data, size_t length)
+    {
+        if (length > SizeInBytes)
+        {
+            return false;
+        }
+        std::memcpy(bytes.data(), data, length);
+        std::fill(bytes.begin() + length, bytes.end(), 0xFF);
+        return true;
+    }
+
+    [[nodiscard]] const std::array<uint8_t, SizeInBytes> &getBytes() const
+    {
+        return bytes;
+    }
+
+private:
+    std::array<uint8_t, SizeInBytes> bytes;
+};
+
+} // namespace settings
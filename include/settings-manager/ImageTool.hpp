@@ -0,0 +1,243 @@
+#pragma once
+
+#include "settings-manager/ImageMemory.hpp"
+#include "settings-manager/SettingsContainer.hpp"
+#include "settings-manager/SettingsText.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace settings
+{
+
+namespace detail
+{
+template <class Container>
+struct TextOf;
+
+template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray>
+struct TextOf<SettingsContainer<SettingsCount, entryArray>>
+{
+    using type = SettingsText<SettingsCount, entryArray>;
+};
+} // namespace detail
+
+/// Host side import and export of EEPROM images, built from the SettingsIO of the firmware with
+/// an ImageMemory of the same size and page size as the target EEPROM:
+///
+///     using Memory = settings::ImageMemory<Eeprom::getSizeInBytes(), Eeprom::getPageSize()>;
+///     using IO = settings::SettingsIO<Count, FirmwareSettings::EntryArray, Memory, 2>;
+///     int main(int argc, char **argv) { return settings::ImageTool<IO>{}.run(argc, argv); }
+///
+/// Exported images are validated like on the target, but their values are dumped as saved:
+/// values out of bounds are kept and content saved with another settings table is not migrated
+/// but rejected. Imported images are created like the target saves them. One ImageTool handles
+/// any number of images, reusing its memory, container and buffers.
+/// @tparam IO SettingsIO with an ImageMemory
+template <class IO>
+class ImageTool
+{
+public:
+    using Container = typename IO::Container;
+    using Memory = typename IO::Memory;
+    using Text = typename detail::TextOf<Container>::type;
+
+    ImageTool() = default;
+    // the SettingsIO refers to the members
+    ImageTool(const ImageTool &) = delete;
+    ImageTool &operator=(const ImageTool &) = delete;
+
+    /// Appends the values of an image dump as text or JSON, as saved.
+    /// @return false if the dump is bigger than the memory or holds no valid settings of the
+    /// current settings table, nothing is appended then
+    bool exportImage(const uint8_t *data, size_t length, bool asJson, std::string &text)
+    {
+        typename Container::ValueArray values;
+        if (!memory.assign(data, length) || !io.readSavedValues(values))
+        {
+            return false;
+        }
+        if (asJson)
+        {
+            Text::appendJson(values, text);
+        }
+        else
+        {
+            Text::appendText(values, text);
+        }
+        return true;
+    }
+
+    /// Creates an image from a text config, see SettingsText::readText(). Settings not
+    /// mentioned get their default value. The image is available by getMemory().
+    TextImportResult importText(std::string_view text)
+    {
+        memory.erase();
+        // writes defaults
+        static_cast<void>(io.loadSettings());
+        const TextImportResult Result = Text::readText(text, settings);
+        io.saveSettings();
+        return Result;
+    }
+
+    [[nodiscard]] const Memory &getMemory() const
+    {
+        return memory;
+    }
+
+    /// Command line front end:
+    ///     export [--json] IMAGE...   values of every image, to stdout
+    ///     import CONFIG IMAGE        creates IMAGE from the text file CONFIG
+    /// Errors go to stderr.
+    /// @return exit code, 0 on success
+    int run(int argc, const char *const *argv)
+    {
+        const std::string_view Command = argc > 1 ? argv[1] : "";
+        if (Command == "export" && argc > 2)
+        {
+            const bool AsJson = std::string_view{argv[2]} == "--json";
+            return exportFiles(argv + (AsJson ? 3 : 2), argv + argc, AsJson);
+        }
+        if (Command == "import" && argc == 4)
+        {
+            return importFile(argv[2], argv[3]);
+        }
+        std::fprintf(stderr, "usage: %s export [--json] IMAGE...\n"
+                             "       %s import CONFIG IMAGE\n",
+                     argc > 0 ? argv[0] : "image-tool", argc > 0 ? argv[0] : "image-tool");
+        return 2;
+    }
+
+private:
+    Memory memory;
+    Container settings;
+    IO io{memory, settings};
+
+    std::vector<uint8_t> fileBuffer;
+    std::string textBuffer;
+
+    int exportFiles(const char *const *first, const char *const *last, bool asJson)
+    {
+        const bool IsBatch = last - first > 1;
+        bool isFirst = true;
+        int exitCode = 0;
+        textBuffer.clear();
+        if (asJson && IsBatch)
+        {
+            textBuffer.push_back('{');
+        }
+
+        for (const char *const *path = first; path != last; ++path)
+        {
+            if (!readFile(*path, Memory::getSizeInBytes() + 1))
+            {
+                exitCode = 1;
+                continue;
+            }
+
+            const size_t Begin = textBuffer.size();
+            if (IsBatch)
+            {
+                textBuffer.append(asJson ? (isFirst ? "\n\"" : ",\n\"") : "# ");
+                if (asJson)
+                {
+                    Text::appendEscaped(*path, textBuffer);
+                }
+                else
+                {
+                    textBuffer.append(*path);
+                }
+                textBuffer.append(asJson ? "\": " : "\n");
+            }
+            if (!exportImage(fileBuffer.data(), fileBuffer.size(), asJson, textBuffer))
+            {
+                std::fprintf(stderr, "%s: no valid settings image\n", *path);
+                textBuffer.resize(Begin);
+                exitCode = 1;
+                continue;
+            }
+            if (!asJson || !IsBatch)
+            {
+                textBuffer.push_back('\n');
+            }
+            isFirst = false;
+
+            // keep the buffer small for big batches
+            if (textBuffer.size() > 1 << 16)
+            {
+                std::fwrite(textBuffer.data(), 1, textBuffer.size(), stdout);
+                textBuffer.clear();
+            }
+        }
+
+        if (asJson && IsBatch)
+        {
+            textBuffer.append("\n}\n");
+        }
+        std::fwrite(textBuffer.data(), 1, textBuffer.size(), stdout);
+        return exitCode;
+    }
+
+    int importFile(const char *configPath, const char *imagePath)
+    {
+        if (!readFile(configPath, SIZE_MAX))
+        {
+            return 1;
+        }
+        const TextImportResult Result = importText(
+            std::string_view{reinterpret_cast<const char *>(fileBuffer.data()), fileBuffer.size()});
+        if (!Result.isValid())
+        {
+            std::fprintf(stderr,
+                         "%s:%zu: %zu unknown settings, %zu invalid values, image not written\n",
+                         configPath, Result.firstErrorLine, Result.unknownNameCount,
+                         Result.invalidValueCount);
+            return 1;
+        }
+
+        std::FILE *file = std::fopen(imagePath, "wb");
+        const bool IsWritten =
+            file != nullptr && std::fwrite(memory.getBytes().data(), 1, memory.getBytes().size(),
+                                           file) == memory.getBytes().size();
+        if (file == nullptr || std::fclose(file) != 0 || !IsWritten)
+        {
+            std::fprintf(stderr, "%s: can't write image\n", imagePath);
+            return 1;
+        }
+        return 0;
+    }
+
+    /// Reads a whole file into fileBuffer.
+    /// @param maxLength reading stops after maxLength bytes
+    /// @return false if the file can't be opened or read, e.g. a directory
+    bool readFile(const char *path, size_t maxLength)
+    {
+        std::FILE *file = std::fopen(path, "rb");
+        if (file == nullptr)
+        {
+            std::fprintf(stderr, "%s: can't open\n", path);
+            return false;
+        }
+        fileBuffer.clear();
+        uint8_t chunk[4096];
+        size_t length = 0;
+        while (fileBuffer.size() < maxLength &&
+               (length = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+        {
+            fileBuffer.insert(fileBuffer.end(), chunk, chunk + length);
+        }
+        const bool IsRead = std::ferror(file) == 0;
+        std::fclose(file);
+        if (!IsRead)
+        {
+            std::fprintf(stderr, "%s: can't read\n", path);
+        }
+        return IsRead;
+    }
+};
+
+} // namespace settings
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <core/SafeAssert.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace settings
+{
+
+/// Fixed size set of setting indices, one bit per index.
+/// Iteration visits only set bits and skips empty words.
+/// @tparam Size number of indices
+template <size_t Size>
+class IndexSet
+{
+public:
+    static constexpr size_t BitsPerWord = 32;
+    static constexpr size_t WordCount = Size == 0 ? 1 : (Size + BitsPerWord - 1) / BitsPerWord;
+    using Words = std::array<uint32_t, WordCount>;
+
+    void set(size_t index)
+    {
+        SafeAssert(index < Size);
+        words[index / BitsPerWord] |= bitOf(index);
+    }
+
+    void reset(size_t index)
+    {
+        SafeAssert(index < Size);
+        words[index / BitsPerWord] &= ~bitOf(index);
+    }
+
+    [[nodiscard]] bool test(size_t index) const
+    {
+        SafeAssert(index < Size);
+        return (words[index / BitsPerWord] & bitOf(index)) != 0;
+    }
+
+    void clear()
+    {
+        words.fill(0);
+    }
+
+    [[nodiscard]] bool any() const
+    {
+        for (const auto Word : words)
+        {
+            if (Word != 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] size_t count() const
+    {
+        size_t result = 0;
+        for (const auto Word : words)
+        {
+            result += __builtin_popcount(Word);
+        }
+        return result;
+    }
+
+    /// @return lowest set index, Size if none is set
+    [[nodiscard]] size_t findFirst() const
+    {
+        for (size_t w = 0; w < WordCount; ++w)
+        {
+            if (words[w] != 0)
+            {
+                return w * BitsPerWord + __builtin_ctz(words[w]);
+            }
+        }
+        return Size;
+    }
+
+    /// Calls function(index) for every set index in ascending order.
+    template <typename Function>
+    void forEach(Function &&function) const
+    {
+        for (size_t w = 0; w < WordCount; ++w)
+        {
+            uint32_t word = words[w];
+            while (word != 0)
+            {
+                function(w * BitsPerWord + __builtin_ctz(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+    [[nodiscard]] const Words &getWords() const
+    {
+        return words;
+    }
+
+    bool operator==(const IndexSet &other) const
+    {
+        return words == other.words;
+    }
+
+    bool operator!=(const IndexSet &other) const
+    {
+        return !((*this) == other);
+    }
+
+private:
+    Words words{};
+
+    static constexpr uint32_t bitOf(size_t index)
+    {
+        return 1UL << (index % BitsPerWord);
+    }
+};
+
+} // namespace settings
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "settings-manager/LittleEndian.hpp"
+
+#include <core/hash.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace settings
+{
+
+/// Integrity policies for the values hash of SettingsIO.
+/// A policy hashes a byte stream in one or more chunks:
+///     auto state = Policy::init();
+///     state = Policy::update(state, begin, end);
+///     uint64_t hash = Policy::finish(state);
+/// Changing the policy of a SettingsIO invalidates its existing EEPROM content.
+
+/// FNV-1a, one multiply per byte. Default.
+struct FnvIntegrity
+{
+    using State = uint64_t;
+
+    [[nodiscard]] static constexpr State init()
+    {
+        return core::hash::HASH_SEED;
+    }
+
+    [[nodiscard]] static State update(State state, const uint8_t *begin, const uint8_t *end)
+    {
+        return core::hash::fnvWithSeed(state, begin, end);
+    }
+
+    [[nodiscard]] static constexpr uint64_t finish(State state)
+    {
+        return state;
+    }
+};
+
+namespace detail
+{
+constexpr uint32_t Crc32Polynomial = 0xEDB88320;
+
+using Crc32Table = std::array<uint32_t, 256>;
+
+/// tables[0] is the classic byte table, tables[n] advances a byte by n further zero bytes
+[[nodiscard]] constexpr std::array<Crc32Table, 8> createCrc32Tables(uint32_t polynomial)
+{
+    std::array<Crc32Table, 8> tables{};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i;
+        for (size_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1) != 0 ? (crc >> 1) ^ polynomial : crc >> 1;
+        }
+        tables[0][i] = crc;
+    }
+    for (size_t n = 1; n < tables.size(); ++n)
+    {
+        for (size_t i = 0; i < 256; ++i)
+        {
+            const uint32_t Previous = tables[n - 1][i];
+            tables[n][i] = tables[0][Previous & 0xFF] ^ (Previous >> 8);
+        }
+    }
+    return tables;
+}
+
+[[nodiscard]] constexpr std::array<uint16_t, 256> createCrc16Table(uint16_t polynomial)
+{
+    std::array<uint16_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i << 8;
+        for (size_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 0x8000) != 0 ? (crc << 1) ^ polynomial : crc << 1;
+        }
+        table[i] = static_cast<uint16_t>(crc);
+    }
+    return table;
+}
+} // namespace detail
+
+/// CRC-16/CCITT (polynomial 0x1021, initial 0xFFFF, not reflected), one table lookup per byte.
+/// Detects every error burst up to 16 bits. The table takes 512 bytes of flash. Meant for small
+/// blocks like the records of SettingsJournal.
+struct Crc16Integrity
+{
+    using State = uint16_t;
+
+    static constexpr uint16_t Polynomial = 0x1021;
+
+    [[nodiscard]] static constexpr State init()
+    {
+        return 0xFFFF;
+    }
+
+    [[nodiscard]] static State update(State state, const uint8_t *begin, const uint8_t *end)
+    {
+        for (; begin != end; ++begin)
+        {
+            state = static_cast<State>((state << 8) ^ Table[(state >> 8) ^ *begin]);
+        }
+        return state;
+    }
+
+    [[nodiscard]] static constexpr uint64_t finish(State state)
+    {
+        return state;
+    }
+
+private:
+    static constexpr auto Table = detail::createCrc16Table(Polynomial);
+};
+
+/// CRC-32 (IEEE 802.3, reflected), table driven slicing-by-8: eight table lookups per eight
+/// bytes. The tables take 8 KiB of flash.
+struct Crc32Integrity
+{
+    using State = uint32_t;
+
+    static constexpr uint32_t Polynomial = detail::Crc32Polynomial;
+
+    [[nodiscard]] static constexpr State init()
+    {
+        return 0xFFFFFFFF;
+    }
+
+    [[nodiscard]] static State update(State state, const uint8_t *begin, const uint8_t *end)
+    {
+        for (; end - begin >= 8; begin += 8)
+        {
+            const uint32_t Low = state ^ loadLittleEndian(begin);
+            const uint32_t High = loadLittleEndian(begin + 4);
+            state = Tables[7][Low & 0xFF] ^ Tables[6][(Low >> 8) & 0xFF] ^
+                    Tables[5][(Low >> 16) & 0xFF] ^ Tables[4][Low >> 24] ^
+                    Tables[3][High & 0xFF] ^ Tables[2][(High >> 8) & 0xFF] ^
+                    Tables[1][(High >> 16) & 0xFF] ^ Tables[0][High >> 24];
+        }
+        for (; begin != end; ++begin)
+        {
+            state = Tables[0][(state ^ *begin) & 0xFF] ^ (state >> 8);
+        }
+        return state;
+    }
+
+    [[nodiscard]] static constexpr uint64_t finish(State state)
+    {
+        return state ^ 0xFFFFFFFF;
+    }
+
+private:
+    static constexpr auto Tables = detail::createCrc32Tables(Polynomial);
+
+    [[nodiscard]] static uint32_t loadLittleEndian(const uint8_t *bytes)
+    {
+        return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+               static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+    }
+};
+
+/// MurmurHash3 (x86, 32 bit), consumes a whole 32 bit word per step with 32 bit multiplies
+/// only, the cheapest on Cortex-M. Words are loaded little endian, a plain load on Cortex-M.
+/// Incremental updates have to be split at word borders, a trailing partial word finishes the
+/// word stream.
+struct WordIntegrity
+{
+    struct State
+    {
+        uint32_t hash = 0;
+        uint32_t length = 0;
+    };
+
+    [[nodiscard]] static constexpr State init()
+    {
+        return State{};
+    }
+
+    [[nodiscard]] static State update(State state, const uint8_t *begin, const uint8_t *end)
+    {
+        state.length += static_cast<uint32_t>(end - begin);
+        for (; end - begin >= 4; begin += 4)
+        {
+            LittleEndian<uint32_t> word;
+            std::memcpy(&word, begin, sizeof(word));
+            state.hash ^= mixWord(word);
+            state.hash = rotateLeft(state.hash, 13) * 5 + 0xE6546B64;
+        }
+
+        uint32_t tail = 0;
+        for (size_t i = static_cast<size_t>(end - begin); i > 0; --i)
+        {
+            tail = (tail << 8) | begin[i - 1];
+        }
+        if (begin != end)
+        {
+            state.hash ^= mixWord(tail);
+        }
+        return state;
+    }
+
+    [[nodiscard]] static constexpr uint64_t finish(State state)
+    {
+        uint32_t hash = state.hash ^ state.length;
+        hash ^= hash >> 16;
+        hash *= 0x85EBCA6B;
+        hash ^= hash >> 13;
+        hash *= 0xC2B2AE35;
+        hash ^= hash >> 16;
+        return hash;
+    }
+
+private:
+    [[nodiscard]] static constexpr uint32_t rotateLeft(uint32_t value, uint32_t bits)
+    {
+        return (value << bits) | (value >> (32 - bits));
+    }
+
+    [[nodiscard]] static constexpr uint32_t mixWord(uint32_t word)
+    {
+        return rotateLeft(word * 0xCC9E2D51, 15) * 0x1B873593;
+    }
+};
+
+} // namespace settings
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace settings
+{
+
+/// Statistics policies of SettingsIO, counting its EEPROM transactions.
+/// SettingsIO calls the hooks of its policy, see SettingsIO::getStatistics():
+///     statistics.countRead(length);
+///     statistics.countPageWrite(length);      // one page program
+///     statistics.countLoad(isValid);
+///     statistics.countLoadFailure(cause);     // no valid content found
+///     statistics.countOutOfRangeLoad();       // values reset to default
+///     statistics.beginSave();
+///     statistics.endSave();
+
+/// Why a load found no valid content. Checks are done in this order, with several slots the
+/// one passing most checks is counted.
+enum class LoadFailure : uint8_t
+{
+    signature,
+    namesHash,
+    valuesHash,
+};
+
+/// Counts nothing, every hook compiles to nothing. Default.
+struct NoStatistics
+{
+    static constexpr bool IsEnabled = false;
+
+    void countRead(size_t)
+    {
+    }
+    void countPageWrite(size_t)
+    {
+    }
+    void countLoad(bool)
+    {
+    }
+    void countLoadFailure(LoadFailure)
+    {
+    }
+    void countOutOfRangeLoad()
+    {
+    }
+    void beginSave()
+    {
+    }
+    void endSave()
+    {
+    }
+};
+
+/// Counts loads, saves, bytes and page programs and measures the duration of saves.
+/// Counters wrap around, subtract two readings to get the traffic of a period.
+/// @tparam Clock time source like std::chrono::steady_clock: static now() returning a
+/// Clock::time_point, Clock::duration
+template <class Clock>
+struct IoStatistics
+{
+    static constexpr bool IsEnabled = true;
+    using Duration = typename Clock::duration;
+
+    /// finished loads, including failed ones
+    uint32_t loadCount = 0;
+    /// finished saves, without the write back of a load
+    uint32_t saveCount = 0;
+    uint32_t bytesRead = 0;
+    uint32_t bytesWritten = 0;
+    /// every page write programs one EEPROM page
+    uint32_t pagePrograms = 0;
+
+    /// failed loads by cause, see LoadFailure
+    uint32_t signatureFailures = 0;
+    uint32_t namesHashFailures = 0;
+    uint32_t valuesHashFailures = 0;
+    /// valid loads with values out of bounds, which were reset to default
+    uint32_t outOfRangeLoads = 0;
+
+    /// from the start of a save to its last page write, asynchronous ones including all polls
+    Duration lastSaveDuration{};
+    Duration maxSaveDuration{};
+
+    void countRead(size_t length)
+    {
+        bytesRead += static_cast<uint32_t>(length);
+    }
+
+    void countPageWrite(size_t length)
+    {
+        bytesWritten += static_cast<uint32_t>(length);
+        pagePrograms++;
+    }
+
+    void countLoad(bool)
+    {
+        loadCount++;
+    }
+
+    void countLoadFailure(LoadFailure cause)
+    {
+        switch (cause)
+        {
+        case LoadFailure::signature:
+            signatureFailures++;
+            break;
+        case LoadFailure::namesHash:
+            namesHashFailures++;
+            break;
+        default:
+            valuesHashFailures++;
+            break;
+        }
+    }
+
+    void countOutOfRangeLoad()
+    {
+        outOfRangeLoads++;
+    }
+
+    void beginSave()
+    {
+        saveStart = Clock::now();
+    }
+
+    void endSave()
+    {
+        saveCount++;
+        lastSaveDuration = Clock::now() - saveStart;
+        if (lastSaveDuration > maxSaveDuration)
+        {
+            maxSaveDuration = lastSaveDuration;
+        }
+    }
+
+private:
+    typename Clock::time_point saveStart{};
+};
+
+} // namespace settings
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace settings
+{
+
+/// Unsigned integer of fixed width, stored little endian on every target.
+/// For EEPROM content read on other targets, e.g. by host tools. Byte aligned, so structs of
+/// them have no padding. Converts implicitly, so fields read like plain integers. On little
+/// endian targets conversions compile to plain loads / stores.
+template <class T>
+class LittleEndian
+{
+public:
+    static_assert(std::is_unsigned_v<T>);
+
+    constexpr LittleEndian(T value = 0)
+    {
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    constexpr operator T() const
+    {
+        T value = 0;
+        for (size_t i = sizeof(T); i > 0; --i)
+        {
+            value = static_cast<T>((value << 8) | bytes[i - 1]);
+        }
+        return value;
+    }
+
+private:
+    std::array<uint8_t, sizeof(T)> bytes{};
+};
+
+} // namespace settings
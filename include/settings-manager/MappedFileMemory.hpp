@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <core/SafeAssert.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace settings
+{
+
+/// File as memory of a SettingsIO on Linux, mapped with mmap. Reads and writes are copies from /
+/// to the mapping, data() reads it without any copy. SettingsIO compares its settings tables and
+/// hashes migrated values in place by data(). Every write is made durable with msync
+/// before it returns, so a save is durable once SettingsIO finished it, without calling flush().
+///
+/// Use two slots, SettingsIO<..., 2>, for crash safety: a save only writes the slot not holding
+/// the newest content, so a power loss while writing leaves the previous content valid and
+/// loadable. No rewrite of the whole file and no rename. Pages are multiples of the system page
+/// size, so the kernel never writes back both slots with one page.
+///
+/// A new file, or the part missing in a shorter one, reads as erased EEPROM (0xFF).
+/// @tparam SizeInBytes size of the mapped file part
+/// @tparam PageSizeInBytes page size reported to SettingsIO, slots start at page boundaries.
+/// A multiple of the system page size, the file doesn't open otherwise.
+template <size_t SizeInBytes, size_t PageSizeInBytes = 4096>
+class MappedFileMemory
+{
+public:
+    /// Opens or creates the file. Check isOpen() afterwards.
+    explicit MappedFileMemory(const char *path)
+    {
+        if (PageSizeInBytes % static_cast<size_t>(::sysconf(_SC_PAGESIZE)) != 0)
+        {
+            return;
+        }
+        fileDescriptor = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        struct stat status = {};
+        if (fileDescriptor < 0 || ::fstat(fileDescriptor, &status) != 0)
+        {
+            close();
+            return;
+        }
+
+        const auto FileSize = static_cast<size_t>(status.st_size);
+        if (FileSize < SizeInBytes && ::ftruncate(fileDescriptor, SizeInBytes) != 0)
+        {
+            close();
+            return;
+        }
+
+        void *const Mapping = ::mmap(nullptr, SizeInBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                                     fileDescriptor, 0);
+        if (Mapping == MAP_FAILED)
+        {
+            close();
+            return;
+        }
+        bytes = static_cast<uint8_t *>(Mapping);
+
+        if (FileSize < SizeInBytes)
+        {
+            std::memset(bytes + FileSize, 0xFF, SizeInBytes - FileSize);
+            // the new file size is metadata, not covered by msync
+            if (!sync(FileSize, SizeInBytes - FileSize) || ::fdatasync(fileDescriptor) != 0)
+            {
+                close();
+            }
+        }
+    }
+
+    // owns the mapping
+    MappedFileMemory(const MappedFileMemory &) = delete;
+    MappedFileMemory &operator=(const MappedFileMemory &) = delete;
+
+    ~MappedFileMemory()
+    {
+        flush();
+        close();
+    }
+
+    static constexpr size_t getSizeInBytes()
+    {
+        return SizeInBytes;
+    }
+
+    static constexpr size_t getPageSize()
+    {
+        return PageSizeInBytes;
+    }
+
+    [[nodiscard]] bool isOpen() const
+    {
+        return bytes != nullptr;
+    }
+
+    void read(size_t address, uint8_t *buffer, size_t length) const
+    {
+        SafeAssert(isOpen());
+        SafeAssert(address + length <= SizeInBytes);
+        std::memcpy(buffer, bytes + address, length);
+    }
+
+    void write(size_t address, const uint8_t *data, size_t length)
+    {
+        SafeAssert(isOpen());
+        SafeAssert(address + length <= SizeInBytes);
+        std::memcpy(bytes + address, data, length);
+        if (!sync(address, length))
+        {
+            markDirty(address, length);
+        }
+    }
+
+    /// Content of the file, without copying.
+    [[nodiscard]] const uint8_t *data() const
+    {
+        return bytes;
+    }
+
+    /// Retries syncing writes the kernel reported an error for.
+    /// @return false if the kernel reported an error again, the writes stay pending
+    bool flush()
+    {
+        if (!isOpen() || dirtyBegin >= dirtyEnd)
+        {
+            return true;
+        }
+        if (!sync(dirtyBegin, dirtyEnd - dirtyBegin))
+        {
+            return false;
+        }
+        dirtyBegin = SizeInBytes;
+        dirtyEnd = 0;
+        return true;
+    }
+
+    /// Bytes written but not durable yet, 0 if everything is durable.
+    [[nodiscard]] size_t getDirtySize() const
+    {
+        return dirtyBegin < dirtyEnd ? dirtyEnd - dirtyBegin : 0;
+    }
+
+private:
+    int fileDescriptor = -1;
+    uint8_t *bytes = nullptr;
+    // range not durable yet, empty if begin >= end
+    size_t dirtyBegin = SizeInBytes;
+    size_t dirtyEnd = 0;
+
+    /// Writes the pages of a range to the file and waits for completion.
+    bool sync(size_t address, size_t length)
+    {
+        const size_t Begin = address / PageSizeInBytes * PageSizeInBytes;
+        return ::msync(bytes + Begin, address + length - Begin, MS_SYNC) == 0;
+    }
+
+    void markDirty(size_t address, size_t length)
+    {
+        dirtyBegin = std::min(dirtyBegin, address);
+        dirtyEnd = std::max(dirtyEnd, address + length);
+    }
+
+    void close()
+    {
+        if (bytes != nullptr)
+        {
+            ::munmap(bytes, SizeInBytes);
+            bytes = nullptr;
+        }
+        if (fileDescriptor >= 0)
+        {
+            ::close(fileDescriptor);
+            fileDescriptor = -1;
+        }
+    }
+};
+
+} // namespace settings
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace settings
+{
+
+template <class MemoryType, class = void>
+struct HasPageSize : std::false_type
+{
+};
+
+template <class MemoryType>
+struct HasPageSize<MemoryType, std::void_t<decltype(MemoryType::getPageSize())>>
+    : std::true_type
+{
+};
+
+/// Compile time properties of the memory behind SettingsIO.
+/// Memories report their page size by a static constexpr getPageSize(), as EepromBase does.
+template <class MemoryType>
+struct MemoryTraits
+{
+    static_assert(HasPageSize<MemoryType>::value,
+                  "MemoryType must provide a static constexpr getPageSize()");
+
+    static constexpr size_t PageSize = MemoryType::getPageSize();
+    static_assert(PageSize > 0);
+};
+
+/// Size of the memory, reported by a static constexpr getSizeInBytes(). Unbounded for others.
+template <class MemoryType, class = void>
+struct MemorySize
+{
+    static constexpr size_t SizeInBytes = std::numeric_limits<size_t>::max();
+};
+
+template <class MemoryType>
+struct MemorySize<MemoryType, std::void_t<decltype(MemoryType::getSizeInBytes())>>
+{
+    static constexpr size_t SizeInBytes = MemoryType::getSizeInBytes();
+};
+
+template <class MemoryType, class = void>
+struct HasIsReady : std::false_type
+{
+};
+
+template <class MemoryType>
+struct HasIsReady<MemoryType, std::void_t<decltype(std::declval<MemoryType &>().isReady())>>
+    : std::true_type
+{
+};
+
+/// Memories mapped into the address space, e.g. MappedFileMemory, provide their content by
+/// data(). SettingsIO reads them in place then, instead of copying into buffers.
+template <class MemoryType, class = void>
+struct HasData : std::false_type
+{
+};
+
+template <class MemoryType>
+struct HasData<MemoryType,
+               std::enable_if_t<std::is_same_v<decltype(std::declval<const MemoryType &>().data()),
+                                               const uint8_t *>>> : std::true_type
+{
+};
+
+/// True if memory accepts the next access. Memories without an isReady() block inside their
+/// read() / write() and are always ready.
+template <class MemoryType>
+[[nodiscard]] bool isMemoryReady(MemoryType &memory)
+{
+    if constexpr (HasIsReady<MemoryType>::value)
+    {
+        return memory.isReady();
+    }
+    else
+    {
+        return true;
+    }
+}
+
+} // namespace settings
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "settings-manager/EntryTables.hpp"
+#include "settings-manager/SettingsEntry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+
+namespace settings
+{
+
+/// Compile time generated perfect hash over the names of an entry array (hash and displace).
+/// Every entry owns exactly one slot, so a runtime lookup costs one name hash, one displacement
+/// lookup and one confirming string compare - independent of SettingsCount.
+/// @tparam SettingsCount
+/// @tparam entryArray
+template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray>
+class NameIndex
+{
+public:
+    /// Looks up a setting by name.
+    /// @return existence and index of the setting
+    [[nodiscard]] static constexpr std::tuple<bool, size_t> find(const std::string_view &name)
+    {
+        const auto [exists, index] = findHash(core::hash::fnvStringview(name));
+        if (exists && Tables::hasSameName(index, name))
+        {
+            return std::make_tuple(true, index);
+        }
+        return std::make_tuple(false, 0);
+    }
+
+    /// Looks up a setting by its NameHash only, without confirming the name.
+    /// @return existence and index of the setting
+    [[nodiscard]] static constexpr std::tuple<bool, size_t> findHash(const uint64_t nameHash)
+    {
+        const size_t Slot = slotOf(nameHash, Table.displacements[bucketOf(nameHash)]);
+        const size_t Index = Table.slots[Slot];
+        if (Index != EmptySlot && Tables::getNameHash(Index) == nameHash)
+        {
+            return std::make_tuple(true, Index);
+        }
+        return std::make_tuple(false, 0);
+    }
+
+    /// False if two entries share a NameHash, either by duplicate names or a hash collision.
+    [[nodiscard]] static constexpr bool isValid()
+    {
+        return Table.isValid;
+    }
+
+    /// True when every entry is found at its own position. Evaluated at compile time.
+    [[nodiscard]] static constexpr bool isConsistent()
+    {
+        if (!isValid())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            const auto [exists, index] = find(entryArray[i].name);
+            if (!exists || index != i)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    using Tables = EntryTables<SettingsCount, entryArray>;
+    using Index_t = std::conditional_t<(SettingsCount < std::numeric_limits<uint16_t>::max()),
+                                       uint16_t, uint32_t>;
+    using Displacement_t = uint16_t;
+
+    static constexpr Index_t EmptySlot = std::numeric_limits<Index_t>::max();
+
+    [[nodiscard]] static constexpr size_t nextPowerOfTwo(size_t value)
+    {
+        size_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // two entries per bucket on average, slots are at most half occupied
+    static constexpr size_t BucketCount = nextPowerOfTwo((SettingsCount + 1) / 2);
+    static constexpr size_t SlotCount = 2 * nextPowerOfTwo(SettingsCount);
+
+    [[nodiscard]] static constexpr uint64_t mix(uint64_t hash)
+    {
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    [[nodiscard]] static constexpr size_t bucketOf(const uint64_t nameHash)
+    {
+        return static_cast<size_t>(mix(nameHash) & (BucketCount - 1));
+    }
+
+    [[nodiscard]] static constexpr size_t slotOf(const uint64_t nameHash,
+                                                 const Displacement_t displacement)
+    {
+        constexpr uint64_t GoldenRatio = 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(mix(nameHash ^ ((displacement + 1ULL) * GoldenRatio)) &
+                                   (SlotCount - 1));
+    }
+
+    struct HashTable
+    {
+        std::array<Displacement_t, BucketCount> displacements{};
+        std::array<Index_t, SlotCount> slots{};
+        bool isValid = false;
+    };
+
+    [[nodiscard]] static constexpr HashTable build()
+    {
+        HashTable table{};
+        for (auto &slot : table.slots)
+        {
+            slot = EmptySlot;
+        }
+
+        // counting sort of entries by bucket
+        std::array<size_t, BucketCount + 1> bucketStart{};
+        for (const auto &entry : entryArray)
+        {
+            bucketStart[bucketOf(entry.NameHash) + 1]++;
+        }
+        size_t largestBucket = 0;
+        for (size_t b = 0; b < BucketCount; ++b)
+        {
+            largestBucket = std::max(largestBucket, bucketStart[b + 1]);
+            bucketStart[b + 1] += bucketStart[b];
+        }
+        std::array<Index_t, SettingsCount + 1> members{};
+        std::array<size_t, BucketCount + 1> cursor = bucketStart;
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            members[cursor[bucketOf(entryArray[i].NameHash)]++] = static_cast<Index_t>(i);
+        }
+
+        // place biggest buckets first, they are the hardest to fit
+        for (size_t bucketSize = largestBucket; bucketSize > 0; --bucketSize)
+        {
+            for (size_t b = 0; b < BucketCount; ++b)
+            {
+                if (bucketStart[b + 1] - bucketStart[b] != bucketSize)
+                {
+                    continue;
+                }
+
+                if (containsEqualHashes(members, bucketStart[b], bucketStart[b + 1]))
+                {
+                    // either duplicate names or a hash collision, no displacement can separate them
+                    return table;
+                }
+
+                bool isPlaced = false;
+                for (size_t d = 0; d <= std::numeric_limits<Displacement_t>::max() && !isPlaced;
+                     ++d)
+                {
+                    isPlaced = fitsBucket(table, members, bucketStart[b], bucketStart[b + 1],
+                                          static_cast<Displacement_t>(d));
+                    if (isPlaced)
+                    {
+                        table.displacements[b] = static_cast<Displacement_t>(d);
+                        for (size_t m = bucketStart[b]; m < bucketStart[b + 1]; ++m)
+                        {
+                            table.slots[slotOf(entryArray[members[m]].NameHash,
+                                               static_cast<Displacement_t>(d))] = members[m];
+                        }
+                    }
+                }
+
+                if (!isPlaced)
+                {
+                    return table;
+                }
+            }
+        }
+
+        table.isValid = true;
+        return table;
+    }
+
+    [[nodiscard]] static constexpr bool
+    containsEqualHashes(const std::array<Index_t, SettingsCount + 1> &members, const size_t begin,
+                        const size_t end)
+    {
+        for (size_t m = begin; m < end; ++m)
+        {
+            for (size_t other = begin; other < m; ++other)
+            {
+                if (entryArray[members[m]].hasSameHash(entryArray[members[other]].NameHash))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] static constexpr bool
+    fitsBucket(const HashTable &table, const std::array<Index_t, SettingsCount + 1> &members,
+               const size_t begin, const size_t end, const Displacement_t displacement)
+    {
+        for (size_t m = begin; m < end; ++m)
+        {
+            const size_t Slot = slotOf(entryArray[members[m]].NameHash, displacement);
+            if (table.slots[Slot] != EmptySlot)
+            {
+                return false;
+            }
+            for (size_t other = begin; other < m; ++other)
+            {
+                if (slotOf(entryArray[members[other]].NameHash, displacement) == Slot)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    static constexpr HashTable Table = build();
+};
+
+} // namespace settings
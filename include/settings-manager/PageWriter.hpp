@@ -0,0 +1,140 @@
+#pragma once
+
+#include "settings-manager/IndexSet.hpp"
+#include "settings-manager/MemoryTraits.hpp"
+
+#include <core/SafeAssert.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace settings
+{
+
+/// Writes a memory image located at baseAddress page by page.
+/// Changed regions are collected as pending pages first. Every pending page is then written with
+/// a single, page aligned write, which is one page program of the EEPROM. Pages without changes
+/// are never written.
+/// @tparam MemoryType memory with write(address, data, length), page size from MemoryTraits
+/// @tparam ImageSize size of the image in bytes
+template <class MemoryType, size_t ImageSize>
+class PageWriter
+{
+public:
+    static constexpr size_t PageSize = MemoryTraits<MemoryType>::PageSize;
+
+    // an image not starting at a page boundary spans one more page
+    static constexpr size_t MaxPageCount = (ImageSize + PageSize - 1) / PageSize + 1;
+
+    PageWriter(MemoryType &memory, size_t baseAddress)
+        : memory(memory),           //
+          baseAddress(baseAddress), //
+          firstPage(pageOf(0))      //
+    {
+    }
+
+    /// Marks all pages touched by image bytes [offset, offset + length) as pending.
+    void markChanged(size_t offset, size_t length)
+    {
+        if (length == 0)
+        {
+            return;
+        }
+        SafeAssert(offset + length <= ImageSize);
+        for (size_t page = pageOf(offset); page <= pageOf(offset + length - 1); ++page)
+        {
+            pendingPages.set(page - firstPage);
+        }
+    }
+
+    void markAll()
+    {
+        markChanged(0, ImageSize);
+    }
+
+    void clear()
+    {
+        pendingPages.clear();
+    }
+
+    [[nodiscard]] bool hasPendingPages() const
+    {
+        return pendingPages.any();
+    }
+
+    [[nodiscard]] size_t getPendingPageCount() const
+    {
+        return pendingPages.count();
+    }
+
+    /// Writes the lowest pending page of image.
+    /// @return bytes written, 0 if nothing was pending
+    size_t writeNextPage(const uint8_t *image)
+    {
+        return writeNextPage(image, ImageSize, nullptr);
+    }
+
+    /// Writes the lowest pending page of an image kept in two parts, e.g. values in RAM followed
+    /// by constant data in flash. A page spanning both parts is assembled on the stack, so it is
+    /// still written at once.
+    /// @param head image bytes [0, headSize)
+    /// @param tail image bytes [headSize, ImageSize)
+    /// @return bytes written, 0 if nothing was pending
+    size_t writeNextPage(const uint8_t *head, size_t headSize, const uint8_t *tail)
+    {
+        const size_t Page = pendingPages.findFirst();
+        if (Page == MaxPageCount)
+        {
+            return 0;
+        }
+        const size_t Begin = std::max(pageBegin(firstPage + Page), baseAddress) - baseAddress;
+        const size_t End =
+            std::min(pageBegin(firstPage + Page + 1), baseAddress + ImageSize) - baseAddress;
+        if (End <= headSize)
+        {
+            memory.write(baseAddress + Begin, head + Begin, End - Begin);
+        }
+        else if (Begin >= headSize)
+        {
+            memory.write(baseAddress + Begin, tail + (Begin - headSize), End - Begin);
+        }
+        else
+        {
+            std::array<uint8_t, PageSize> page;
+            std::copy(head + Begin, head + headSize, page.begin());
+            std::copy(tail, tail + (End - headSize), page.begin() + (headSize - Begin));
+            memory.write(baseAddress + Begin, page.data(), End - Begin);
+        }
+        pendingPages.reset(Page);
+        return End - Begin;
+    }
+
+    /// Writes all pending pages of image. Blocking.
+    void writePendingPages(const uint8_t *image)
+    {
+        while (writeNextPage(image))
+        {
+        }
+    }
+
+private:
+    MemoryType &memory;
+    const size_t baseAddress;
+    const size_t firstPage;
+    IndexSet<MaxPageCount> pendingPages;
+
+    /// absolute page of an image offset
+    [[nodiscard]] size_t pageOf(size_t offset) const
+    {
+        return (baseAddress + offset) / PageSize;
+    }
+
+    [[nodiscard]] static constexpr size_t pageBegin(size_t page)
+    {
+        return page * PageSize;
+    }
+};
+
+} // namespace settings
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <core/SafeAssert.h>
+
+#include <cstdint>
+
+namespace settings
+{
+
+/// Saves changed settings automatically, debounced and rate limited, through a SettingsIO.
+/// Bursts of changes, e.g. a parameter dragged in a GUI, end up in a single save: a save starts
+/// once no value changed for quietPeriod, or maxDelay after the first unsaved change at the
+/// latest. Saves start minInterval apart at least, which bounds the EEPROM wear.
+///
+/// Call poll() periodically from the thread changing settings, e.g. the config task. Saves run
+/// asynchronously by SettingsIO::startSave(), poll() drives them one page per call.
+/// Changes are detected by the dirty entries of the SettingsContainer, so don't clear them
+/// elsewhere. Blocking saves of the same SettingsIO in between are fine.
+/// @tparam IO SettingsIO
+/// @tparam Clock time source like std::chrono::steady_clock: static now() returning a
+/// Clock::time_point, Clock::duration
+template <class IO, class Clock>
+class SaveScheduler
+{
+public:
+    using Container = typename IO::Container;
+    using Duration = typename Clock::duration;
+
+    struct Timing
+    {
+        /// time without changes before saving
+        Duration quietPeriod;
+        /// longest time a change stays unsaved while values keep changing
+        Duration maxDelay;
+        /// shortest time between the start of two saves
+        Duration minInterval;
+    };
+
+    SaveScheduler(IO &io, Container &settings, const Timing &timing)
+        : io(io),             //
+          settings(settings), //
+          timing(timing)      //
+    {
+        SafeAssert(timing.quietPeriod <= timing.maxDelay);
+    }
+
+    /// Drives a running save, starts a new one when it is due.
+    /// @return true if a save was started
+    bool poll()
+    {
+        if (io.isBusy())
+        {
+            io.poll();
+            return false;
+        }
+
+        const auto Now = Clock::now();
+        const uint32_t WriteCount = settings.getWriteCount();
+        if (!settings.hasDirtyEntries())
+        {
+            hasPendingChanges = false;
+            lastWriteCount = WriteCount;
+            return false;
+        }
+
+        if (!hasPendingChanges)
+        {
+            hasPendingChanges = true;
+            firstChange = Now;
+            lastChange = Now;
+        }
+        else if (WriteCount != lastWriteCount)
+        {
+            lastChange = Now;
+        }
+        lastWriteCount = WriteCount;
+
+        const bool IsDue =
+            Now - lastChange >= timing.quietPeriod || Now - firstChange >= timing.maxDelay;
+        const bool IsAllowed = !hasSaved || Now - lastSave >= timing.minInterval;
+        if (!IsDue || !IsAllowed || !io.startSave())
+        {
+            return false;
+        }
+        lastSave = Now;
+        hasSaved = true;
+        hasPendingChanges = false;
+        return true;
+    }
+
+    /// Finishes a running save and saves all changes immediately, ignoring the timing. Blocking.
+    /// E.g. before a shutdown.
+    void flush()
+    {
+        while (io.poll())
+        {
+        }
+        if (settings.hasDirtyEntries())
+        {
+            io.saveChangedSettings();
+            lastSave = Clock::now();
+            hasSaved = true;
+        }
+        hasPendingChanges = false;
+        lastWriteCount = settings.getWriteCount();
+    }
+
+    /// Changes waiting for their save to start.
+    [[nodiscard]] bool isSavePending() const
+    {
+        return hasPendingChanges;
+    }
+
+private:
+    IO &io;
+    Container &settings;
+    const Timing timing;
+
+    bool hasPendingChanges = false;
+    bool hasSaved = false;
+    uint32_t lastWriteCount = 0;
+    typename Clock::time_point firstChange{};
+    typename Clock::time_point lastChange{};
+    typename Clock::time_point lastSave{};
+};
+
+} // namespace settings
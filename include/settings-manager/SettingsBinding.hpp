@@ -0,0 +1,123 @@
+#pragma once
+
+#include "settings-manager/SettingsEntry.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace settings
+{
+
+/// C++ type of the values of a setting type.
+template <VariableType Type>
+using NativeValue_t = std::conditional_t<
+    Type == VariableType::integerType, int32_t,
+    std::conditional_t<Type == VariableType::booleanType, bool, SettingsValue_t>>;
+
+namespace detail
+{
+/// Type assigned to a bound member, the value type of atomics.
+template <typename T>
+struct AssignedType
+{
+    using type = T;
+};
+
+template <typename T>
+struct AssignedType<std::atomic<T>>
+{
+    using type = T;
+};
+} // namespace detail
+
+/// Default conversion of a SettingsBinding.
+template <typename T>
+struct StaticCastConversion
+{
+    template <typename Native>
+    [[nodiscard]] constexpr T operator()(Native value) const
+    {
+        return static_cast<T>(value);
+    }
+};
+
+/// Node of the intrusive list of bindings of a SettingsContainer, see SettingsBinding.
+class SettingsBindingNode
+{
+public:
+    explicit SettingsBindingNode(size_t index) : index(index)
+    {
+    }
+    // linked by address
+    SettingsBindingNode(const SettingsBindingNode &) = delete;
+    SettingsBindingNode &operator=(const SettingsBindingNode &) = delete;
+    virtual ~SettingsBindingNode() = default;
+
+    /// Writes a raw value of the setting, see ValueLayout, to the bound location.
+    virtual void update(uint32_t raw) = 0;
+
+    [[nodiscard]] size_t getIndex() const
+    {
+        return index;
+    }
+
+private:
+    template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray>
+    friend class SettingsContainer;
+
+    const size_t index;
+    SettingsBindingNode *previous = nullptr;
+    SettingsBindingNode *next = nullptr;
+};
+
+/// Binds a member variable of a consumer to a setting: the SettingsContainer writes every new
+/// value of the setting straight into it, converted by Converter. So the consumer reads a plain
+/// field, without any lookup, virtual call or onSettingsUpdate() refresh.
+/// Writes the current value on construction and unbinds on destruction, so declare it after the
+/// bound member.
+///
+/// The bound member is written by the thread changing settings, right after the values. Read it
+/// from the same thread, or bind a std::atomic for other threads.
+/// @tparam Container SettingsContainer the name belongs to
+/// @tparam name setting, resolved at compile time
+/// @tparam T type of the bound member, the native type of the setting by default
+/// @tparam Converter converts the native value to T, e.g. into a units type
+template <class Container, const std::string_view &name,
+          typename T = NativeValue_t<Container::template getVariableType<name>()>,
+          class Converter = StaticCastConversion<typename detail::AssignedType<T>::type>>
+class SettingsBinding final : public SettingsBindingNode
+{
+public:
+    static constexpr VariableType Type = Container::template getVariableType<name>();
+    using Native = NativeValue_t<Type>;
+
+    SettingsBinding(Container &settings, T &target, Converter converter = Converter{})
+        : SettingsBindingNode(Container::template getIndex<name>()), //
+          settings(settings),                                        //
+          target(target),                                            //
+          converter(converter)                                       //
+    {
+        settings.bind(*this);
+    }
+
+    ~SettingsBinding() override
+    {
+        settings.unbind(*this);
+    }
+
+    void update(uint32_t raw) override
+    {
+        target = converter(Container::Layout::template decodeAs<Type, Native>(raw));
+    }
+
+private:
+    Container &settings;
+    T &target;
+    Converter converter;
+};
+
+} // namespace settings
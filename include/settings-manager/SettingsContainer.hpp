@@ -1,37 +1,112 @@
 #pragma once
+#include "settings-manager/EntryTables.hpp"
+#include "settings-manager/IndexSet.hpp"
+#include "settings-manager/NameIndex.hpp"
+#include "settings-manager/SettingsBinding.hpp"
 #include "settings-manager/SettingsEntry.hpp"
+#include "settings-manager/SettingsUser.hpp"
+#include "settings-manager/SortedNameIndex.hpp"
+#include "settings-manager/ValueAccess.hpp"
+#include "settings-manager/ValueLayout.hpp"
 #include <core/SafeAssert.h>
 #include <tuple>
+#include <utility>
 
 namespace settings
 {
 
+/// New value of a setting given by index, see SettingsContainer::setValues().
+struct IndexedValue
+{
+    size_t index = 0;
+    SettingsValue_t value = 0;
+};
+
+/// Called on every runtime name lookup of the SettingsContainer of entryArray, each costs one
+/// name hash and at most one string compare. Does nothing, tests specialize it to count lookups.
+template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray>
+struct NameLookupObserver
+{
+    static void onLookup()
+    {
+    }
+};
+
 /// Searching, setting, getting settings values.
 /// Does compiletime validation of static settings content.
+/// Values are stored natively by type, see ValueLayout.
+///
+/// Values are plain words by default. With SeqLockAccess, chosen by ValueAccessOf, they may be
+/// read from any thread without locking and getValues() / copyValuesTo() read several values
+/// consistently, see ValueAccess.hpp.
 /// @tparam SettingsCount
 /// @tparam entryArray
 template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray>
 class SettingsContainer
 {
 public:
+    using Layout = ValueLayout<SettingsCount, entryArray>;
+    /// lexicographic order of the names, e.g. for lowerBound() queries of tools
+    using SortedNames = SortedNameIndex<SettingsCount, entryArray>;
+    using Raw_t = typename Layout::Raw_t;
+    /// all values in their storage and EEPROM layout
+    using ValueArray = typename Layout::Words;
+    /// number of settings, booleans packed into ValueArray make it shorter
+    static constexpr size_t EntryCount = SettingsCount;
+    /// see ValueAccess.hpp
+    using Access = typename ValueAccessOf<SettingsCount, entryArray>::type;
+
     SettingsContainer()
     {
         static_assert(!containsDuplicates());
         static_assert(allStaticEntriesValid());
+        static_assert(Index::isConsistent());
         resetAllToDefault();
+        clearDirtyEntries();
+        unnotifiedEntries.clear();
         // TODO hookup settings IO and wait until loaded
     };
 
+    SettingsContainer(const SettingsContainer &other)
+    {
+        *this = other;
+    }
+
+    SettingsContainer &operator=(const SettingsContainer &other)
+    {
+        ValueArray values;
+        other.copyValuesTo(values);
+        // bindings stay with this container, the ones of changed values are written
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            if (bindings[i] != nullptr && loadRaw(i) != Layout::getRaw(values, i))
+            {
+                unboundEntries.set(i);
+            }
+        }
+        containerArray.beginWrite();
+        for (size_t w = 0; w < values.size(); ++w)
+        {
+            containerArray.store(w, values[w]);
+        }
+        containerArray.endWrite();
+        dirtyEntries = other.dirtyEntries;
+        unnotifiedEntries = other.unnotifiedEntries;
+        updateBindings();
+        return *this;
+    }
+
     /// Retrieves a settings value by name / index.
     /// Name templated overload determines setting existence at compile time. Zero lookup cost.
-    /// String overload ASSERTS setting existence. String search on every lookup.
+    /// String overload ASSERTS setting existence. Name hash lookup on every usage.
     /// Index lookup ASSERTS index validity. Zero lookup cost.
+    /// Values are converted from their native type, integers are exact for integral T.
     /// @tparam T preferred return type, consider using util's unit system
     template <const std::string_view &name, typename T = SettingsValue_t>
     [[nodiscard]] T getValue() const
     {
         constexpr size_t Index = getIndex<name>();
-        return getValue<T>(Index);
+        return Layout::template decodeAs<entryArray[Index].variableType, T>(loadRaw(Index));
     }
 
     template <typename T = SettingsValue_t>
@@ -44,15 +119,7 @@ public:
     [[nodiscard]] T getValue(size_t index) const
     {
         SafeAssert(index < SettingsCount);
-        const auto value = containerArray[index];
-        if constexpr (std::is_same<T, SettingsValue_t>::value)
-        {
-            return value;
-        }
-        else
-        {
-            return static_cast<T>(value);
-        }
+        return Layout::template decode<T>(index, loadRaw(index));
     }
 
     /// Returns the setting's minimum / default / maximum value. Asserts index bounds!
@@ -62,81 +129,186 @@ public:
     [[nodiscard]] SettingsValue_t getMinValue(size_t index)
     {
         SafeAssert(index < SettingsCount);
-        return entryArray[index].minValue;
+        return Tables::toValue(index, Tables::getMinRaw(index));
     }
 
     [[nodiscard]] SettingsValue_t getMaxValue(size_t index)
     {
         SafeAssert(index < SettingsCount);
-        return entryArray[index].maxValue;
+        return Tables::toValue(index, Tables::getMaxRaw(index));
     }
 
     [[nodiscard]] SettingsValue_t getDefaultValue(size_t index)
     {
         SafeAssert(index < SettingsCount);
-        return entryArray[index].defaultValue;
+        return Tables::toValue(index, Tables::getDefaultRaw(index));
     }
 
     /// Sets new value by name / index.
     /// Name templated overload determines setting existence at compile time. Zero cost.
-    /// String overload ASSERTS setting existence. String search on every usage.
+    /// String overload ASSERTS setting existence. Name hash lookup on every usage.
     /// Index lookup ASSERTS index validity. Zero cost.
+    /// Integer settings take integral values exactly and round floating point values.
     /// @return true on success, false if min / max bounds are violated
-    template <const std::string_view &name>
-    bool setValue(const SettingsValue_t newValue)
+    template <const std::string_view &name, typename T = SettingsValue_t>
+    bool setValue(const T newValue)
     {
         constexpr size_t Index = getIndex<name>();
         return setValue(Index, newValue);
     }
 
-    bool setValue(std::string_view name, const SettingsValue_t newValue)
+    template <typename T = SettingsValue_t>
+    bool setValue(std::string_view name, const T newValue)
     {
         return setValue(getIndex(name), newValue);
     }
 
-    bool setValue(size_t Index, const float newValue)
+    template <typename T = SettingsValue_t>
+    bool setValue(size_t Index, const T newValue)
     {
         SafeAssert(Index < SettingsCount);
-        const auto MaxValue = entryArray[Index].maxValue;
-        const auto MinValue = entryArray[Index].minValue;
-
-        if (newValue > MaxValue || newValue < MinValue)
+        const auto [isInBounds, raw] = Layout::encode(Index, newValue);
+        if (!isInBounds)
         {
             return false;
         }
-        containerArray[Index] = newValue;
+        if (loadRaw(Index) != raw)
+        {
+            containerArray.beginWrite();
+            storeRaw(Index, raw);
+            containerArray.endWrite();
+            markChanged(Index);
+            updateBindings(Index);
+        }
         return true;
     }
 
+    /// Sets a group of values by name, with SeqLockAccess readers of getValues() on other threads
+    /// see either all old or all new values. Nothing is changed if any new value violates its
+    /// bounds.
+    /// @return true on success, false if min / max bounds are violated
+    template <const std::string_view &... names>
+    bool setValues(const std::array<SettingsValue_t, sizeof...(names)> &newValues)
+    {
+        constexpr std::array<size_t, sizeof...(names)> Indices{getIndex<names>()...};
+        std::array<Raw_t, sizeof...(names)> raws{};
+        for (size_t i = 0; i < Indices.size(); ++i)
+        {
+            const auto [isInBounds, raw] = Layout::encode(Indices[i], newValues[i]);
+            if (!isInBounds)
+            {
+                return false;
+            }
+            raws[i] = raw;
+        }
+
+        containerArray.beginWrite();
+        for (size_t i = 0; i < Indices.size(); ++i)
+        {
+            if (loadRaw(Indices[i]) != raws[i])
+            {
+                storeRaw(Indices[i], raws[i]);
+                markChanged(Indices[i]);
+            }
+        }
+        containerArray.endWrite();
+        updateBindings();
+        return true;
+    }
+
+    /// Sets a batch of values by index, e.g. a profile resolved by getIndex() once.
+    /// All bounds are checked first, nothing is changed if any new value violates its bounds.
+    /// Values are written in one pass, with SeqLockAccess readers of getValues() see either all
+    /// old or all new values. Changed settings are marked dirty and unnotified, so a single
+    /// notifySettingsUsers() notifies the affected users only and a single saveChangedSettings()
+    /// or startSave() of SettingsIO saves them. Duplicate indices: the last value wins.
+    /// Index lookup ASSERTS index validity.
+    /// @return true on success, false if min / max bounds are violated
+    bool setValues(const IndexedValue *newValues, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            SafeAssert(newValues[i].index < SettingsCount);
+            if (!std::get<0>(Layout::encode(newValues[i].index, newValues[i].value)))
+            {
+                return false;
+            }
+        }
+
+        containerArray.beginWrite();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t Index = newValues[i].index;
+            const Raw_t Raw = std::get<1>(Layout::encode(Index, newValues[i].value));
+            if (loadRaw(Index) != Raw)
+            {
+                storeRaw(Index, Raw);
+                markChanged(Index);
+            }
+        }
+        containerArray.endWrite();
+        updateBindings();
+        return true;
+    }
+
+    template <size_t Count>
+    bool setValues(const std::array<IndexedValue, Count> &newValues)
+    {
+        return setValues(newValues.data(), Count);
+    }
+
+    /// Reads a group of values by name consistently, with SeqLockAccess also while another thread
+    /// runs setValues() / assignValues().
+    template <const std::string_view &... names>
+    [[nodiscard]] std::array<SettingsValue_t, sizeof...(names)> getValues() const
+    {
+        std::array<SettingsValue_t, sizeof...(names)> values{};
+        containerArray.readConsistent(
+            [&]()
+            {
+                values = {getValue<names>()...};
+            });
+        return values;
+    }
+
     /// Add to value by name / index.
     /// Name templated overload determines setting existence at compile time. Zero cost.
-    /// String overload ASSERTS setting existence. String search on every usage.
+    /// String overload ASSERTS setting existence. Name hash lookup on every usage.
     /// Index lookup ASSERTS index validity. Zero cost.
     /// @return true on success, false if min / max bounds are violated
 
-    template <const std::string_view &name>
-    bool addToValue(const SettingsValue_t addValue)
+    template <const std::string_view &name, typename T = SettingsValue_t>
+    bool addToValue(const T addValue)
     {
         constexpr size_t Index = getIndex<name>();
         return addToValue(Index, addValue);
     }
 
-    bool addToValue(std::string_view name, const SettingsValue_t addValue)
+    template <typename T = SettingsValue_t>
+    bool addToValue(std::string_view name, const T addValue)
     {
         return addToValue(getIndex(name), addValue);
     }
 
-    bool addToValue(size_t Index, const float addValue)
+    template <typename T = SettingsValue_t>
+    bool addToValue(size_t Index, const T addValue)
     {
-        return setValue(Index, getValue(Index) + addValue);
+        if constexpr (std::is_integral_v<T>)
+        {
+            if (getVariableType(Index) == VariableType::integerType)
+            {
+                // exact, even beyond the float mantissa
+                return setValue(Index, getValue<int64_t>(Index) + addValue);
+            }
+        }
+        return setValue(Index, getValue<double>(Index) + addValue);
     }
 
     /// Get the values type by name/index - only relevant for UAVCAN's param server.
     template <const std::string_view &name>
-    [[nodiscard]] VariableType getVariableType() const
+    [[nodiscard]] static constexpr VariableType getVariableType()
     {
-        constexpr size_t Index = getIndex<name>();
-        return getVariableType(Index);
+        return entryArray[getIndex<name>()].variableType;
     }
 
     [[nodiscard]] VariableType getVariableType(std::string_view name) const
@@ -147,16 +319,32 @@ public:
     [[nodiscard]] VariableType getVariableType(size_t index) const
     {
         SafeAssert(index < SettingsCount);
-        return entryArray[index].variableType;
+        return Tables::getVariableType(index);
+    }
+
+    /// Name of a setting, e.g. to list all settings. Asserts index bounds!
+    [[nodiscard]] std::string_view getName(size_t index) const
+    {
+        SafeAssert(index < SettingsCount);
+        return Tables::getName(index);
+    }
+
+    /// Calls function(index) for every setting below a hierarchical prefix, e.g. "motor.", in
+    /// name order. O(log N) string compares plus one per setting found, see SortedNameIndex.
+    template <typename Function>
+    void forEachWithPrefix(std::string_view prefix, Function &&function) const
+    {
+        SortedNames::forEachWithPrefix(prefix, std::forward<Function>(function));
     }
 
     /// Retrieves a setting index.
     /// Name templated overload determines setting existence at compile time. Zero cost.
-    /// String overload ASSERTS setting existence. String search on every usage. Asserts setting's
-    /// existence!
+    /// String overload ASSERTS setting existence. One name hash and one string compare on every
+    /// usage through the compile time generated NameIndex. Asserts setting's existence!
     [[nodiscard]] size_t getIndex(std::string_view name) const
     {
-        const std::tuple<bool, size_t> ret = getIndex_Aux(name);
+        NameLookupObserver<SettingsCount, entryArray>::onLookup();
+        const std::tuple<bool, size_t> ret = Index::find(name);
         SafeAssert(std::get<0>(ret));
         return std::get<1>(ret);
     }
@@ -175,12 +363,149 @@ public:
 
     void resetAllToDefault()
     {
+        containerArray.beginWrite();
         for (size_t i = 0; i < SettingsCount; ++i)
         {
-            containerArray[i] = entryArray[i].defaultValue;
+            if (loadRaw(i) != Layout::getDefaultRaw(i))
+            {
+                markChanged(i);
+            }
+        }
+        for (size_t w = 0; w < DefaultValues.size(); ++w)
+        {
+            containerArray.store(w, DefaultValues[w]);
+        }
+        containerArray.endWrite();
+        updateBindings();
+    }
+
+    /// Settings changed since the last clearDirtyEntries(), e.g. since the last save.
+    [[nodiscard]] const IndexSet<SettingsCount> &getDirtyEntries() const
+    {
+        return dirtyEntries;
+    }
+
+    [[nodiscard]] bool hasDirtyEntries() const
+    {
+        return dirtyEntries.any();
+    }
+
+    void clearDirtyEntries()
+    {
+        dirtyEntries.clear();
+    }
+
+    /// Calls onSettingsUpdate() of the SettingsUsers depending on settings changed since the last
+    /// notification. Users without declared dependencies are notified on any change.
+    void notifySettingsUsers()
+    {
+        if (!unnotifiedEntries.any())
+        {
+            return;
+        }
+        // users may change settings while being notified, these changes trigger the next round
+        const IndexSet<SettingsCount> Changes = unnotifiedEntries;
+        unnotifiedEntries.clear();
+        SettingsUser::notifySettingsUpdate(SettingsChanges{getIdentity(), Changes});
+    }
+
+    /// Same for all instances of this container type, tells its SettingsChanges apart from the
+    /// ones of other settings tables.
+    [[nodiscard]] static constexpr const void *getIdentity()
+    {
+        return &entryArray;
+    }
+
+    /// Settings changed since the last notifySettingsUsers().
+    [[nodiscard]] const IndexSet<SettingsCount> &getUnnotifiedEntries() const
+    {
+        return unnotifiedEntries;
+    }
+
+    /// Registers a binding and writes the current value to it, see SettingsBinding.
+    /// Bindings are written after every change of their setting. Each setting has its own list,
+    /// so a write walks the bindings of the changed settings only. Bind and unbind from the thread
+    /// changing values.
+    void bind(SettingsBindingNode &binding)
+    {
+        const size_t Index = binding.getIndex();
+        SafeAssert(Index < SettingsCount);
+        binding.previous = nullptr;
+        binding.next = bindings[Index];
+        if (bindings[Index] != nullptr)
+        {
+            bindings[Index]->previous = &binding;
+        }
+        bindings[Index] = &binding;
+        binding.update(loadRaw(Index));
+    }
+
+    void unbind(SettingsBindingNode &binding)
+    {
+        if (binding.previous != nullptr)
+        {
+            binding.previous->next = binding.next;
+        }
+        else
+        {
+            SafeAssert(bindings[binding.getIndex()] == &binding);
+            bindings[binding.getIndex()] = binding.next;
+        }
+        if (binding.next != nullptr)
+        {
+            binding.next->previous = binding.previous;
+        }
+        binding.previous = nullptr;
+        binding.next = nullptr;
+    }
+
+    /// Number of writes of values, changes whenever values may have changed. Wraps around.
+    [[nodiscard]] uint32_t getWriteCount() const
+    {
+        return containerArray.getWriteCount();
+    }
+
+    /// Copies all values consistently in index order, e.g. for persisting them.
+    void copyValuesTo(ValueArray &destination) const
+    {
+        containerArray.readConsistent(
+            [&]()
+            {
+                for (size_t w = 0; w < destination.size(); ++w)
+                {
+                    destination[w] = containerArray.load(w);
+                }
+            });
+    }
+
+    /// Replaces all values in a single pass over the entries.
+    /// Values violating their bounds are replaced by their default value.
+    /// Changed values are marked dirty. Written in place, without a copy of the values.
+    /// @return number of values which were out of bounds
+    size_t assignValues(const ValueArray &source)
+    {
+        size_t outOfBoundsCount = 0;
+        containerArray.beginWrite();
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            const auto Raw = Layout::getRaw(source, i);
+            const bool IsOutOfBounds = !Layout::isInBounds(i, Raw);
+            const auto NewRaw = IsOutOfBounds ? Layout::getDefaultRaw(i) : Raw;
+            const size_t Word = Layout::wordOf(i);
+            const auto OldWord = containerArray.load(Word);
+            if (Layout::extractRaw(i, OldWord) != NewRaw)
+            {
+                markChanged(i);
+                containerArray.store(Word, Layout::insertRaw(i, OldWord, NewRaw));
+            }
+            outOfBoundsCount += IsOutOfBounds ? 1 : 0;
         }
+        containerArray.endWrite();
+        updateBindings();
+        return outOfBoundsCount;
     }
 
+    /// The entry array itself. Keeps it in flash, prefer the EntryTables accessors like getName().
     [[nodiscard]] constexpr const std::array<SettingsEntry, SettingsCount> &getAllSettings() const
     {
         return entryArray;
@@ -188,13 +513,18 @@ public:
 
     [[nodiscard]] bool doesSettingExist(std::string_view name) const
     {
-        const auto [exists, index] = getIndex_Aux(name);
+        NameLookupObserver<SettingsCount, entryArray>::onLookup();
+        const auto [exists, index] = Index::find(name);
         return exists;
     }
 
     bool operator==(const SettingsContainer<SettingsCount, entryArray> &other) const
     {
-        return containerArray == other.containerArray;
+        ValueArray values;
+        ValueArray otherValues;
+        copyValuesTo(values);
+        other.copyValuesTo(otherValues);
+        return values == otherValues;
     }
 
     bool operator!=(const SettingsContainer<SettingsCount, entryArray> &other) const
@@ -203,8 +533,67 @@ public:
     }
 
 private:
-    std::array<SettingsValue_t, SettingsCount> containerArray;
+    using Index = NameIndex<SettingsCount, entryArray>;
+    using Tables = typename Layout::Tables;
+
+    typename Access::template Words<Raw_t, std::tuple_size_v<ValueArray>> containerArray;
+    IndexSet<SettingsCount> dirtyEntries;
+    IndexSet<SettingsCount> unnotifiedEntries;
+
+    /// first binding of each setting
+    std::array<SettingsBindingNode *, SettingsCount> bindings{};
+    /// changed settings with bindings not written yet
+    IndexSet<SettingsCount> unboundEntries;
+
+    [[nodiscard]] Raw_t loadRaw(size_t index) const
+    {
+        return Layout::extractRaw(index, containerArray.load(Layout::wordOf(index)));
+    }
+
+    /// Only between beginWrite() / endWrite() of containerArray. Booleans share words, which is
+    /// fine for one writer.
+    void storeRaw(size_t index, Raw_t raw)
+    {
+        const size_t Word = Layout::wordOf(index);
+        containerArray.store(Word, Layout::insertRaw(index, containerArray.load(Word), raw));
+    }
+
+    void markChanged(size_t index)
+    {
+        dirtyEntries.set(index);
+        unnotifiedEntries.set(index);
+        if (bindings[index] != nullptr)
+        {
+            unboundEntries.set(index);
+        }
+    }
+
+    /// Writes changed values to their bindings, after a write.
+    void updateBindings()
+    {
+        if (!unboundEntries.any())
+        {
+            return;
+        }
+        const IndexSet<SettingsCount> Changes = unboundEntries;
+        Changes.forEach([this](size_t index) { updateBindings(index); });
+    }
+
+    /// Writes the value of a setting to its bindings, after a write.
+    void updateBindings(size_t index)
+    {
+        unboundEntries.reset(index);
+        const Raw_t Raw = loadRaw(index);
+        for (SettingsBindingNode *binding = bindings[index]; binding != nullptr;
+             binding = binding->next)
+        {
+            binding->update(Raw);
+        }
+    }
+
+    static constexpr ValueArray DefaultValues = Layout::createDefaultWords();
 
+    /// Linear search, used for compile time lookups and as cross-check of the NameIndex.
     [[nodiscard]] static constexpr std::tuple<bool, size_t>
     getIndex_Aux(const std::string_view &name)
     {
@@ -218,23 +607,11 @@ private:
         return std::make_tuple(false, 0);
     }
 
+    /// Identical names share a NameHash, which makes building the NameIndex fail.
+    /// Linear instead of comparing every pair of names.
     [[nodiscard]] static constexpr bool containsDuplicates()
     {
-        for (const auto &i : entryArray)
-        {
-            for (const auto &j : entryArray)
-            {
-                if (std::addressof(i) == std::addressof(j))
-                {
-                    continue;
-                }
-                if (i.hasSameName(j.name))
-                {
-                    return true;
-                }
-            }
-        }
-        return false;
+        return !Index::isValid();
     }
 
     [[nodiscard]] static constexpr bool allStaticEntriesValid()
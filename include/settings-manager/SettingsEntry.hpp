@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/hash.hpp"
+#include <cstdint>
 #include <string_view>
 
 namespace settings
@@ -15,6 +16,9 @@ enum class VariableType
 };
 
 /// A single settings entry. Static content.
+/// Values are stored natively depending on variableType: float for realType, int32_t for
+/// integerType and a single bit for booleanType. Integer entries keep exact integer bounds, the
+/// float bounds are for generic access only.
 class SettingsEntry
 {
 public:
@@ -24,24 +28,44 @@ public:
     const std::string_view name;
     const VariableType variableType;
     const uint64_t NameHash;
+    const int32_t minInteger;
+    const int32_t defaultInteger;
+    const int32_t maxInteger;
 
     //----------------------------------------------------------------------------------------------
     constexpr SettingsEntry(const SettingsValue_t min, const SettingsValue_t defaultValue,
                             const SettingsValue_t max, std::string_view name,
                             const VariableType variableType = VariableType::realType)
         : minValue{min}, defaultValue{defaultValue}, maxValue{max}, name{name},
-          variableType{variableType}, NameHash{core::hash::fnvStringview(name)}
+          variableType{variableType}, NameHash{core::hash::fnvStringview(name)},
+          minInteger{toInteger(min)}, defaultInteger{toInteger(defaultValue)},
+          maxInteger{toInteger(max)}
     {
     }
 
     constexpr SettingsEntry(const bool defaultBoolValue, std::string_view name)
         : minValue{0}, defaultValue{defaultBoolValue ? 1.0f : 0.0f}, maxValue{1}, name{name},
-          variableType{VariableType::booleanType}, NameHash{core::hash::fnvStringview(name)}
+          variableType{VariableType::booleanType}, NameHash{core::hash::fnvStringview(name)},
+          minInteger{0}, defaultInteger{defaultBoolValue ? 1 : 0}, maxInteger{1}
     {
     }
 
+    /// Integer entry with exact bounds, also beyond the float mantissa, e.g. INT32_MAX.
+    /// The constructor derives integer bounds from floats.
+    [[nodiscard]] static constexpr SettingsEntry integer(const int32_t min,
+                                                         const int32_t defaultValue,
+                                                         const int32_t max, std::string_view name)
+    {
+        return SettingsEntry{IntegerBounds{}, min, defaultValue, max, name};
+    }
+
     constexpr bool isValid() const
     {
+        if (variableType == VariableType::integerType)
+        {
+            return !(minInteger > maxInteger || defaultInteger > maxInteger ||
+                     defaultInteger < minInteger);
+        }
         return !(minValue > maxValue || defaultValue > maxValue || defaultValue < minValue);
     }
 
@@ -54,5 +78,34 @@ public:
     {
         return NameHash == otherHash;
     }
+
+private:
+    struct IntegerBounds
+    {
+    };
+
+    constexpr SettingsEntry(IntegerBounds, const int32_t min, const int32_t defaultValue,
+                            const int32_t max, std::string_view name)
+        : minValue{static_cast<SettingsValue_t>(min)},
+          defaultValue{static_cast<SettingsValue_t>(defaultValue)},
+          maxValue{static_cast<SettingsValue_t>(max)}, name{name},
+          variableType{VariableType::integerType}, NameHash{core::hash::fnvStringview(name)},
+          minInteger{min}, defaultInteger{defaultValue}, maxInteger{max}
+    {
+    }
+
+    /// saturates, float bounds of integer entries may exceed the int32_t range
+    [[nodiscard]] static constexpr int32_t toInteger(const SettingsValue_t value)
+    {
+        if (value >= 2147483648.0f)
+        {
+            return INT32_MAX;
+        }
+        if (value < -2147483648.0f)
+        {
+            return INT32_MIN;
+        }
+        return static_cast<int32_t>(value);
+    }
 };
 } // namespace settings
\ No newline at end of file
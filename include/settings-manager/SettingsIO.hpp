@@ -1,104 +1,383 @@
 #pragma once
 
+#include "settings-manager/Integrity.hpp"
+#include "settings-manager/IoStatistics.hpp"
+#include "settings-manager/LittleEndian.hpp"
+#include "settings-manager/MemoryTraits.hpp"
+#include "settings-manager/NameIndex.hpp"
+#include "settings-manager/PageWriter.hpp"
 #include "settings-manager/SettingsContainer.hpp"
+#include "settings-manager/ValueFormat.hpp"
 
+#include <algorithm>
 #include <core/hash.hpp>
+#include <cstddef>
+#include <cstring>
 #include <eeprom-driver/EepromBase.hpp>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace settings
 {
 
+/// Storage of the EEPROM image SettingsIO works on.
+/// Images hold headers and values of the slots only, the constant settings table is compared with
+/// and written from the one in flash.
+/// OwnedImage: member of SettingsIO, mirrors the EEPROM content between operations, so a save only
+/// compares values. Default.
+/// ScratchImage: buffer given by the caller, used while an operation is running only and free for
+/// other use in between, e.g. shared by several SettingsIO. Every save reads the slots first.
+struct OwnedImage
+{
+};
+struct ScratchImage
+{
+};
+
 /// Handles saving non-static settings content to eeprom
+/// With two slots every save goes to the slot not holding the newest content, so a power loss
+/// while writing never destroys the last saved settings.
+/// Content saved with another settings table (entries added, removed or reordered) is migrated
+/// on load instead of being reset, see migrateContent().
 /// @tparam SettingsCount
 /// @tparam entryArray
+/// @tparam MemoryType
+/// @tparam SlotCount 1 for a single copy, 2 for A/B slots
+/// @tparam Integrity values hash policy, see Integrity.hpp
+/// @tparam Format format of the saved values, see ValueFormat.hpp
+/// @tparam ImageStorage OwnedImage or ScratchImage
+/// @tparam Statistics EEPROM transaction counters, see IoStatistics.hpp. A private base, so
+/// NoStatistics takes no space.
 template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray,
-          class MemoryType>
-class SettingsIO
+          class MemoryType, size_t SlotCount = 1, class Integrity = FnvIntegrity,
+          class Format = NativeFormat, class ImageStorage = OwnedImage,
+          class Statistics = NoStatistics>
+class SettingsIO : private Statistics
 {
 public:
+    static_assert(SlotCount == 1 || SlotCount == 2);
+    static_assert(std::is_same_v<ImageStorage, OwnedImage> ||
+                  std::is_same_v<ImageStorage, ScratchImage>);
+    static constexpr bool UsesScratchImage = std::is_same_v<ImageStorage, ScratchImage>;
+
+    using Layout = ValueLayout<SettingsCount, entryArray>;
+    using Container = SettingsContainer<SettingsCount, entryArray>;
+    using Memory = MemoryType;
+    using ValueArray = typename Container::ValueArray;
+    using Serializer = typename Format::template Serializer<SettingsCount, entryArray>;
+    using ValueImage = typename Serializer::Image;
+    using FieldWords = typename Serializer::FieldWords;
+
     SettingsIO(MemoryType &eeprom, SettingsContainer<SettingsCount, entryArray> &settings)
-        : eeprom(eeprom),    //
-          settings(settings) //
+        : eeprom(eeprom),                                                       //
+          settings(settings),                                                   //
+          pageWriters(createPageWriters(std::make_index_sequence<SlotCount>{})) //
     {
+        static_assert(!UsesScratchImage, "give a scratch buffer");
+    }
+
+    struct ImageBuffer;
+
+    /// @param scratch holds the EEPROM image while an operation is running, see ScratchImage
+    SettingsIO(MemoryType &eeprom, SettingsContainer<SettingsCount, entryArray> &settings,
+               ImageBuffer &scratch)
+        : eeprom(eeprom),                                                        //
+          settings(settings),                                                    //
+          image(&scratch),                                                       //
+          pageWriters(createPageWriters(std::make_index_sequence<SlotCount>{})) //
+    {
+        static_assert(UsesScratchImage, "OwnedImage doesn't use a scratch buffer");
     }
     virtual ~SettingsIO() = default;
 
+    /// Called when an asynchronous load / save finished.
+    /// @param context pointer given to startLoad() / startSave()
+    /// @param success result like the return value of loadSettings(), always true for saves
+    using CompletionCallback = void (*)(void *context, bool success);
+
     /// Loads settings from EEPROM. Blocking. Updates SettingsContainer with read values on success.
     /// Discards EEPROM content and writes defaults on failure.
+    /// All slots are read in one pass, the newest valid one is used.
     /// @return true on success, false otherwise
     virtual bool loadSettings()
     {
-        eeprom.read(MemoryOffset, reinterpret_cast<uint8_t *>(&rawContent), sizeof(EepromContent));
+        SafeAssert(!isBusy());
+        readSlots(0, LoadSize);
+        const bool IsValid = applyLoadedContent();
+        writePendingPages();
+        return IsValid;
+    }
 
-        // verify header
-        bool isValid =
-            (rawContent.magicString == Signature) &&             //
-            rawContent.settingsNamesHash == settingsNamesHash && //
-            rawContent.settingsValuesHash == hashSettingsValues(rawContent.settingsContainer);
+    /// Loads settings like loadSettings(), but streams the values of the newest slot directly into
+    /// a values array on the stack, hashing them chunk by chunk while reading. Headers and other
+    /// slots are never held in RAM. Values are assigned in place once the whole slot proved valid.
+    /// A migration reuses the array, so with NativeFormat it is the only copy of the values on the
+    /// stack; other formats stream into their smaller image first.
+    /// The scratch buffer is needed only to write back defaults or values out of bounds.
+    /// Requires ScratchImage, an own image would be left outdated.
+    /// @return true on success, false otherwise
+    bool loadSettingsStreaming()
+    {
+        static_assert(UsesScratchImage, "streaming needs ScratchImage, use loadSettings()");
+        SafeAssert(!isBusy());
 
-        // invalid, write sensible defaults
-        if (!isValid)
+        bool isValid = false;
+        bool isWriteBackNeeded = true;
+        bool isMigrated = false;
+        MigratedSlot source;
+        {
+            ValueArray values{};
+            LoadFailure failure = LoadFailure::signature;
+            uint32_t generation = 0;
+            isValid = streamValues(values, generation, failure);
+            if (isValid)
+            {
+                isWriteBackNeeded = settings.assignValues(values) > 0;
+                if (isWriteBackNeeded)
+                {
+                    statistics().countOutOfRangeLoad();
+                }
+            }
+            else if (migrateContent(values, source))
+            {
+                isValid = true;
+                isMigrated = true;
+                settings.assignValues(values);
+            }
+            else
+            {
+                statistics().countLoadFailure(failure);
+                settings.resetAllToDefault();
+            }
+        }
+        statistics().countLoad(isValid);
+
+        if (isMigrated)
+        {
+            readSlotsForSave();
+            snapshotMigratedValues(source);
+            writePendingPages();
+        }
+        else if (isWriteBackNeeded)
+        {
+            save(false);
+        }
+        else
+        {
+            settings.clearDirtyEntries();
+        }
+        return isValid;
+    }
+
+    /// Reads the values of the newest valid slot as saved, e.g. for tools inspecting EEPROM
+    /// images. Blocking. Unlike loadSettings() nothing is corrected, migrated or written and
+    /// SettingsContainer is left as it is, values may be out of bounds.
+    /// @return false if no slot saved with the current settings table is valid
+    bool readSavedValues(ValueArray &values)
+    {
+        uint32_t generation = 0;
+        LoadFailure failure = LoadFailure::signature;
+        return readSavedValues(values, generation, failure);
+    }
+
+    /// Like readSavedValues(values), also tells the generation of the slot read.
+    /// @param failure set to the furthest check any slot passed, if none is valid
+    bool readSavedValues(ValueArray &values, uint32_t &generation, LoadFailure &failure)
+    {
+        SafeAssert(!isBusy());
+        failure = LoadFailure::signature;
+        return streamValues(values, generation, failure);
+    }
+
+    /// Writes settings to EEPROM. Blocking.
+    /// Only EEPROM pages whose content changed since the last load / save are written.
+    virtual void saveSettings()
+    {
+        SafeAssert(!isBusy());
+        statistics().beginSave();
+        save(false);
+        statistics().endSave();
+    }
+
+    /// Writes values changed since the last load / save to EEPROM. Blocking.
+    /// Compares dirty entries of the SettingsContainer only, instead of all values.
+    virtual void saveChangedSettings()
+    {
+        SafeAssert(!isBusy());
+        statistics().beginSave();
+        save(true);
+        statistics().endSave();
+    }
+
+    /// Writes the values of SettingsContainer as content of a new generation, even if the newest
+    /// slot holds them already. Invalidates data bound to the generation of the newest content,
+    /// like the records of SettingsJournal. Blocking.
+    /// @return generation of the written content
+    uint32_t saveNewGeneration()
+    {
+        SafeAssert(!isBusy());
+        statistics().beginSave();
+        readSlotsForSave();
+
+        ValueArray values;
+        settings.copyValuesTo(values);
+        settings.clearDirtyEntries();
+        // without valid content the generations are garbage, start over with the first slot
+        const uint32_t Generation = hasValidSlot ? slotContent(activeSlot).generation + 1 : 1;
+        writeSnapshot(values, hasValidSlot ? (activeSlot + 1) % SlotCount : 0, Generation);
+        writePendingPages();
+        statistics().endSave();
+        return Generation;
+    }
+
+    /// Starts an asynchronous loadSettings(), driven by poll().
+    /// @return false if another operation is still running
+    bool startLoad(CompletionCallback callback = nullptr, void *context = nullptr)
+    {
+        if (isBusy())
         {
-            settings.resetAllToDefault();
-            saveSettings();
             return false;
         }
+        startOperation(State::Loading, callback, context);
+        readOffset = 0;
+        return true;
+    }
 
-        // copy temporary settings to persistent instance
-        bool saveRequired = false;
-        for (const auto &settingEntry : settings.getAllSettings())
+    /// Starts an asynchronous saveSettings(), driven by poll().
+    /// Values are captured immediately, later changes of the SettingsContainer are not part of
+    /// this save and can't tear it. With ScratchImage they are captured once the slots are read.
+    /// @return false if another operation is still running
+    bool startSave(CompletionCallback callback = nullptr, void *context = nullptr)
+    {
+        if (isBusy())
         {
-            if (!settings.setValue(settingEntry.name,
-                                   rawContent.settingsContainer.getValue(settingEntry.name)))
-            {
-                // read settings value is out of range, reset to default
-                settings.setValue(settingEntry.name, settingEntry.defaultValue);
-                rawContent.settingsContainer.setValue(settingEntry.name, settingEntry.defaultValue);
-                saveRequired = true;
-            }
+            return false;
+        }
+        statistics().beginSave();
+        if constexpr (UsesScratchImage)
+        {
+            startOperation(State::ReadingForSave, callback, context);
+            readOffset = 0;
         }
-        if (saveRequired)
+        else
         {
-            saveSettings();
+            startOperation(State::Saving, callback, context);
+            snapshotValues(false);
         }
         return true;
     }
 
-    /// Writes settings to EEPROM. Blocking
-    virtual void saveSettings()
+    /// Does one step of a running asynchronous operation: reads or writes one EEPROM page.
+    /// Does nothing while the memory reports to be busy. Calls the completion callback when the
+    /// operation is finished.
+    /// @return true while the operation is still running
+    bool poll()
     {
-        rawContent.magicString = Signature;
-        rawContent.settingsNamesHash = settingsNamesHash;
+        if (!isBusy() || !isMemoryReady(eeprom))
+        {
+            return isBusy();
+        }
 
-        // copy persistent settings to temporary instance
-        for (const auto &settingEntry : settings.getAllSettings())
+        if (state == State::Loading || state == State::ReadingForSave)
         {
-            const auto Value = settings.getValue(settingEntry.name);
-            SafeAssert(rawContent.settingsContainer.setValue(settingEntry.name, Value));
+            const size_t ChunkEnd = std::min(LoadSize, pageEndOf(readOffset));
+            readSlots(readOffset, ChunkEnd);
+            readOffset = ChunkEnd;
+            if (readOffset == LoadSize)
+            {
+                if (state == State::Loading)
+                {
+                    operationResult = applyLoadedContent();
+                }
+                else
+                {
+                    selectNewestSlot();
+                    snapshotValues(false);
+                }
+                state = State::Saving;
+            }
+            return true;
         }
-        rawContent.settingsValuesHash = hashSettingsValues(rawContent.settingsContainer);
 
-        eeprom.write(MemoryOffset, reinterpret_cast<uint8_t *>(&rawContent), sizeof(EepromContent));
+        const size_t Length =
+            pageWriters[activeSlot].writeNextPage(slotImage(activeSlot), TableOffset, tableBytes());
+        if (Length > 0)
+        {
+            statistics().countPageWrite(Length);
+        }
+        else
+        {
+            state = State::Idle;
+            if (isSaveOperation)
+            {
+                statistics().endSave();
+            }
+            if (callback != nullptr)
+            {
+                callback(callbackContext, operationResult);
+            }
+        }
+        return isBusy();
     }
 
-    static constexpr size_t Signature = 0x0110CA6E;
+    /// True while an asynchronous load / save is running.
+    [[nodiscard]] bool isBusy() const
+    {
+        return state != State::Idle;
+    }
+
+    /// EEPROM transactions so far, empty with NoStatistics.
+    [[nodiscard]] const Statistics &getStatistics() const
+    {
+        return *this;
+    }
+
+    /// versions the content layout
+    static constexpr uint32_t Signature = 0x0110CA6F;
     static constexpr uint16_t MemoryOffset = 0;
+
+    static_assert(SettingsCount < std::numeric_limits<uint16_t>::max());
+
+    /// Types of the entries, 2 bits each.
+    static constexpr size_t TypesPerWord = 16;
+    static constexpr size_t TypeWordCount = (SettingsCount + TypesPerWord - 1) / TypesPerWord;
+    using EntryTypeArray = std::array<LittleEndian<uint32_t>, TypeWordCount>;
+    /// 32 bit words per entry in the settings table: the NameHash, low word first, followed by
+    /// the field words of the Format. Keeps the content free of padding.
+    static constexpr size_t EntryWordCount = 2 + Serializer::FieldWordCount;
+    using EntryHashArray = std::array<LittleEndian<uint32_t>, EntryWordCount * SettingsCount>;
+    static_assert(sizeof(ValueImage) < std::numeric_limits<uint16_t>::max());
+
+    /// Header and settings table are little endian with fixed width fields on every target, the
+    /// values are in the byte order of the Format. Members are byte aligned, so the content has
+    /// no padding in front of the values.
     struct EepromContent
     {
-        // corruption unit test requires every member to be packed until the last one
-        // but putting packed for the whole struct generates a warning
-        // as optimisations to SettingsContainer may change its size
-        // interfering with packing
-        __attribute__((packed)) uint64_t settingsNamesHash = 0;
-        __attribute__((packed)) uint64_t settingsValuesHash = 0;
-        __attribute__((packed)) size_t magicString = Signature;
-        SettingsContainer<SettingsCount, entryArray> settingsContainer;
+        LittleEndian<uint64_t> settingsNamesHash = 0;
+        LittleEndian<uint64_t> settingsValuesHash = 0;
+        LittleEndian<uint32_t> magicString = Signature;
+        // incremented on every save, the newest valid slot wins
+        LittleEndian<uint32_t> generation = 0;
+        // settings table of the values, covered by settingsNamesHash, allows migrating them.
+        // Follows the values, so it is written once and never shares their pages needlessly.
+        LittleEndian<uint16_t> settingsEntryCount = SettingsCount;
+        // bytes of the values, locates the table
+        LittleEndian<uint16_t> settingsValuesSize = sizeof(ValueImage);
+        ValueImage settingsValues{};
+        EntryTypeArray settingsEntryTypes = createEntryTypes();
+        EntryHashArray settingsEntryHashes = createEntryHashes();
 
         bool operator==(const EepromContent &other) const
         {
             return settingsNamesHash == other.settingsNamesHash &&
                    settingsValuesHash == other.settingsValuesHash &&
-                   magicString == other.magicString && settingsContainer == other.settingsContainer;
+                   magicString == other.magicString && generation == other.generation &&
+                   settingsEntryCount == other.settingsEntryCount &&
+                   settingsValuesSize == other.settingsValuesSize &&
+                   settingsValues == other.settingsValues &&
+                   settingsEntryTypes == other.settingsEntryTypes &&
+                   settingsEntryHashes == other.settingsEntryHashes;
         }
         bool operator!=(const EepromContent &other) const
         {
@@ -106,37 +385,908 @@ public:
         }
     };
 
-    [[nodiscard]] static uint64_t
-    hashSettingsValues(SettingsContainer<SettingsCount, entryArray> &container)
+    /// Part of EepromContent held in the image of a slot, up to the settings table.
+    struct ContentHead
+    {
+        LittleEndian<uint64_t> settingsNamesHash = 0;
+        LittleEndian<uint64_t> settingsValuesHash = 0;
+        LittleEndian<uint32_t> magicString = Signature;
+        LittleEndian<uint32_t> generation = 0;
+        LittleEndian<uint16_t> settingsEntryCount = SettingsCount;
+        LittleEndian<uint16_t> settingsValuesSize = sizeof(ValueImage);
+        ValueImage settingsValues{};
+    };
+    static_assert(offsetof(ContentHead, generation) == offsetof(EepromContent, generation));
+    static_assert(offsetof(ContentHead, settingsValues) == offsetof(EepromContent, settingsValues));
+    static_assert(sizeof(ContentHead) == offsetof(EepromContent, settingsEntryTypes));
+
+    static constexpr size_t PageSize = PageWriter<MemoryType, sizeof(EepromContent)>::PageSize;
+
+    /// Slots start at page boundaries, so writing one slot never touches another one.
+    [[nodiscard]] static constexpr size_t getSlotSize(size_t contentSize)
+    {
+        return SlotCount == 1 ? contentSize : (contentSize + PageSize - 1) / PageSize * PageSize;
+    }
+    static constexpr size_t SlotSize = getSlotSize(sizeof(EepromContent));
+    static_assert(SlotCount == 1 || MemoryOffset % PageSize == 0);
+
+    /// members before the values, independent of the settings
+    static constexpr size_t HeaderSize = offsetof(EepromContent, settingsValues);
+
+    /// Size of values saved in NativeFormat with another settings table.
+    [[nodiscard]] static constexpr size_t getNativeValuesSize(size_t entryCount,
+                                                              size_t booleanCount)
+    {
+        const size_t WordCount = entryCount - booleanCount +
+                                 (booleanCount + Layout::BitsPerWord - 1) / Layout::BitsPerWord;
+        return (WordCount == 0 ? 1 : WordCount) * sizeof(typename Layout::Raw_t);
+    }
+
+    /// Size of content saved in the Format with another settings table.
+    [[nodiscard]] static constexpr size_t getOtherContentSize(size_t entryCount,
+                                                              size_t valuesSize)
+    {
+        return roundUp(HeaderSize + valuesSize +
+                           (entryCount + TypesPerWord - 1) / TypesPerWord * sizeof(uint32_t) +
+                           entryCount * EntryWordCount * sizeof(uint32_t),
+                       alignof(EepromContent));
+    }
+
+    [[nodiscard]] static constexpr size_t getSlotOffset(size_t slot)
+    {
+        return MemoryOffset + slot * SlotSize;
+    }
+
+    /// All slots as laid out in EEPROM.
+    static constexpr size_t LoadSize = (SlotCount - 1) * SlotSize + sizeof(EepromContent);
+    /// Header and values of every slot.
+    struct ImageBuffer
+    {
+        alignas(ContentHead) std::array<uint8_t, SlotCount * sizeof(ContentHead)> bytes{};
+    };
+
+    /// Hashes all values in one pass over the contiguous value image, followed by the generation.
+    [[nodiscard]] static uint64_t hashSettingsValues(const ValueImage &values, uint32_t generation)
+    {
+        const auto Begin = reinterpret_cast<const uint8_t *>(values.data());
+        return finishValuesHash(
+            Integrity::update(Integrity::init(), Begin, Begin + sizeof(ValueImage)), generation);
+    }
+
+    /// Bytes of values read and hashed at once by loadSettingsStreaming(), at least one page and
+    /// whole words, so chunks never split a word of WordIntegrity. Settings tables are read and
+    /// compared in chunks of the same size.
+    static constexpr size_t StreamChunkSize = (PageSize + 3) / 4 * 4;
+
+    /// Hashes the settings table, the NameHash, type and field words of every entry. Detects
+    /// changes of the static settings content and thereby of the value layout.
+    [[nodiscard]] static uint64_t hashSettingsNames()
     {
         uint64_t hash = core::hash::HASH_SEED;
-        for (const auto &settingEntry : container.getAllSettings())
+        for (size_t i = 0; i < SettingsCount; ++i)
         {
-            SettingsValue_t value = container.getValue(settingEntry.name);
-            const auto ptr = reinterpret_cast<const uint8_t *>(&value);
-            hash = core::hash::fnvWithSeed(hash, ptr, ptr + sizeof(value));
+            hash = hashEntry(hash, Layout::Tables::getNameHash(i),
+                             Layout::Tables::getVariableType(i), Serializer::getFieldWords(i));
         }
         return hash;
     }
 
+    [[nodiscard]] static constexpr EntryHashArray createEntryHashes()
+    {
+        EntryHashArray hashes{};
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            const size_t First = EntryWordCount * i;
+            hashes[First] = static_cast<uint32_t>(entryArray[i].NameHash);
+            hashes[First + 1] = static_cast<uint32_t>(entryArray[i].NameHash >> 32);
+            const auto FieldWords = Serializer::getFieldWords(i);
+            for (size_t w = 0; w < FieldWords.size(); ++w)
+            {
+                hashes[First + 2 + w] = FieldWords[w];
+            }
+        }
+        return hashes;
+    }
+
+    [[nodiscard]] static constexpr EntryTypeArray createEntryTypes()
+    {
+        EntryTypeArray types{};
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            types[i / TypesPerWord] = types[i / TypesPerWord] |
+                                      static_cast<uint32_t>(entryArray[i].variableType)
+                                          << (2 * (i % TypesPerWord));
+        }
+        return types;
+    }
+
+    static constexpr EntryTypeArray EntryTypes = createEntryTypes();
+    static constexpr EntryHashArray EntryHashes = createEntryHashes();
+
 private:
+    using Writer = PageWriter<MemoryType, sizeof(EepromContent)>;
+
     MemoryType &eeprom;
     SettingsContainer<SettingsCount, entryArray> &settings;
-    EepromContent rawContent;
 
-    [[nodiscard]] static uint64_t hashSettingsNames()
+    /// Equals the EEPROM content apart from pending pages while valid, see ImageStorage.
+    std::conditional_t<UsesScratchImage, ImageBuffer *, ImageBuffer> image{};
+
+    /// pending pages per slot
+    std::array<Writer, SlotCount> pageWriters;
+
+    const uint64_t settingsNamesHash = hashSettingsNames();
+
+    /// image was read from EEPROM, unchanged pages may be skipped
+    bool isContentCached = false;
+
+    /// slot holding the newest content, the next save goes to the following slot
+    size_t activeSlot = SlotCount - 1;
+
+    /// activeSlot contains valid settings
+    bool hasValidSlot = false;
+
+    static constexpr size_t ValuesOffset = offsetof(EepromContent, settingsValues);
+    static constexpr size_t TableOffset = offsetof(EepromContent, settingsEntryTypes);
+
+    /// Settings table as saved behind the values, kept in flash only.
+    struct SettingsTable
     {
-        uint64_t hash = core::hash::HASH_SEED;
-        for (const auto &settingEntry : entryArray)
+        EntryTypeArray settingsEntryTypes;
+        EntryHashArray settingsEntryHashes;
+    };
+    static_assert(sizeof(SettingsTable) == sizeof(EepromContent) - TableOffset);
+    static constexpr SettingsTable Table{EntryTypes, EntryHashes};
+
+    /// per slot, the table last read from EEPROM equals Table
+    std::array<bool, SlotCount> isTableCurrent{};
+
+    [[nodiscard]] Statistics &statistics()
+    {
+        return *this;
+    }
+
+    template <size_t... Slots>
+    std::array<Writer, SlotCount> createPageWriters(std::index_sequence<Slots...>)
+    {
+        return {Writer{eeprom, getSlotOffset(Slots)}...};
+    }
+
+    [[nodiscard]] uint8_t *imageData()
+    {
+        if constexpr (UsesScratchImage)
+        {
+            return image->bytes.data();
+        }
+        else
         {
-            hash = core::hash::fnvWithSeed(
-                hash, reinterpret_cast<const uint8_t *>(std::begin(settingEntry.name)),
-                reinterpret_cast<const uint8_t *>(std::end(settingEntry.name)));
+            return image.bytes.data();
+        }
+    }
+
+    [[nodiscard]] ContentHead &slotContent(size_t slot)
+    {
+        return *reinterpret_cast<ContentHead *>(slotImage(slot));
+    }
+
+    [[nodiscard]] uint8_t *slotImage(size_t slot)
+    {
+        return imageData() + slot * sizeof(ContentHead);
+    }
+
+    [[nodiscard]] static const uint8_t *tableBytes()
+    {
+        return reinterpret_cast<const uint8_t *>(&Table);
+    }
+
+    /// load offset of the end of the page containing offset
+    [[nodiscard]] static constexpr size_t pageEndOf(size_t offset)
+    {
+        return ((MemoryOffset + offset) / PageSize + 1) * PageSize - MemoryOffset;
+    }
+
+    enum class State
+    {
+        Idle,
+        Loading,
+        ReadingForSave,
+        Saving,
+    };
+
+    State state = State::Idle;
+    CompletionCallback callback = nullptr;
+    void *callbackContext = nullptr;
+    bool operationResult = true;
+    bool isSaveOperation = false;
+    size_t readOffset = 0;
+
+    void startOperation(State newState, CompletionCallback newCallback, void *newContext)
+    {
+        state = newState;
+        isSaveOperation = newState != State::Loading;
+        callback = newCallback;
+        callbackContext = newContext;
+        operationResult = true;
+    }
+
+    void readMemory(size_t address, uint8_t *buffer, size_t length)
+    {
+        eeprom.read(address, buffer, length);
+        statistics().countRead(length);
+    }
+
+    /// Bytes of the memory for inspection. Memories providing data() are read in place, others
+    /// are copied into buffer.
+    /// @param buffer at least length bytes
+    [[nodiscard]] const uint8_t *viewMemory(size_t address, uint8_t *buffer, size_t length)
+    {
+        if constexpr (HasData<MemoryType>::value)
+        {
+            statistics().countRead(length);
+            return eeprom.data() + address;
+        }
+        else
+        {
+            readMemory(address, buffer, length);
+            return buffer;
+        }
+    }
+
+    /// Reads the load offsets [begin, end) of all slots, a new read of them starts at 0. Headers
+    /// and values go to the image, settings tables are compared with Table.
+    void readSlots(size_t begin, size_t end)
+    {
+        if (begin == 0)
+        {
+            isTableCurrent.fill(true);
+        }
+        for (size_t slot = 0; slot < SlotCount; ++slot)
+        {
+            const size_t SlotBegin = slot * SlotSize;
+            const size_t HeadBegin = std::max(begin, SlotBegin);
+            const size_t HeadEnd = std::min(end, SlotBegin + TableOffset);
+            if (HeadBegin < HeadEnd)
+            {
+                readMemory(MemoryOffset + HeadBegin, slotImage(slot) + (HeadBegin - SlotBegin),
+                           HeadEnd - HeadBegin);
+            }
+
+            const size_t TableBegin = std::max(begin, SlotBegin + TableOffset);
+            const size_t TableEnd = std::min(end, SlotBegin + sizeof(EepromContent));
+            std::array<uint8_t, StreamChunkSize> chunk;
+            for (size_t offset = TableBegin; offset < TableEnd && isTableCurrent[slot];
+                 offset += StreamChunkSize)
+            {
+                const size_t Length = std::min(StreamChunkSize, TableEnd - offset);
+                isTableCurrent[slot] =
+                    std::memcmp(viewMemory(MemoryOffset + offset, chunk.data(), Length),
+                                tableBytes() + (offset - SlotBegin - TableOffset), Length) == 0;
+            }
+        }
+    }
+
+    void writePendingPages()
+    {
+        while (const size_t Length = pageWriters[activeSlot].writeNextPage(
+                   slotImage(activeSlot), TableOffset, tableBytes()))
+        {
+            statistics().countPageWrite(Length);
+        }
+    }
+
+    void save(bool onlyDirty)
+    {
+        readSlotsForSave();
+        snapshotValues(onlyDirty);
+        writePendingPages();
+    }
+
+    [[nodiscard]] bool isSlotValid(size_t slot)
+    {
+        auto &content = slotContent(slot);
+        return (content.magicString == Signature) &&             //
+               content.settingsNamesHash == settingsNamesHash && //
+               hasCurrentTable(slot) &&                          //
+               content.settingsValuesHash ==
+                   hashSettingsValues(content.settingsValues, content.generation);
+    }
+
+    /// A scratch image is unknown at the start of a save, the slots are read again.
+    void readSlotsForSave()
+    {
+        if constexpr (UsesScratchImage)
+        {
+            readSlots(0, LoadSize);
+            selectNewestSlot();
+        }
+    }
+
+    /// Picks the newest valid slot of a freshly read image and updates SettingsContainer.
+    /// Resets to defaults if no slot is valid. Pages to write back are left pending.
+    /// @return true if a valid slot was found
+    bool applyLoadedContent()
+    {
+        selectNewestSlot();
+
+        if (!hasValidSlot)
+        {
+            // saved with another settings table, values are written back in the current layout
+            ValueArray migratedValues;
+            MigratedSlot source;
+            if (migrateContent(migratedValues, source))
+            {
+                settings.assignValues(migratedValues);
+                snapshotMigratedValues(source);
+                statistics().countLoad(true);
+                return true;
+            }
+
+            if constexpr (Statistics::IsEnabled)
+            {
+                statistics().countLoadFailure(getLoadFailure());
+            }
+            statistics().countLoad(false);
+
+            // invalid, write sensible defaults
+            settings.resetAllToDefault();
+            snapshotValues(false);
+            return false;
+        }
+
+        // copy temporary settings to persistent instance, out of range values are reset to
+        // default and written back
+        if (settings.assignValues(Serializer::deserialize(slotContent(activeSlot).settingsValues)) >
+            0)
+        {
+            statistics().countOutOfRangeLoad();
+        }
+        statistics().countLoad(true);
+        snapshotValues(false);
+        return true;
+    }
+
+    /// Why no slot of a freshly read image is valid, the furthest check any slot passed.
+    [[nodiscard]] LoadFailure getLoadFailure()
+    {
+        auto failure = LoadFailure::signature;
+        for (size_t slot = 0; slot < SlotCount; ++slot)
+        {
+            const auto &Content = slotContent(slot);
+            if (Content.magicString != Signature)
+            {
+                continue;
+            }
+            const bool IsCurrentTable =
+                Content.settingsNamesHash == settingsNamesHash && hasCurrentTable(slot);
+            failure = std::max(failure,
+                               IsCurrentTable ? LoadFailure::valuesHash : LoadFailure::namesHash);
+        }
+        return failure;
+    }
+
+    /// The slot was saved with the current settings table, see readSlots().
+    [[nodiscard]] bool hasCurrentTable(size_t slot)
+    {
+        const auto &Content = slotContent(slot);
+        return isTableCurrent[slot] && Content.settingsEntryCount == SettingsCount &&
+               Content.settingsValuesSize == sizeof(ValueImage);
+    }
+
+    [[nodiscard]] static constexpr size_t roundUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /// Hashes the little endian bytes of the entry, so the hash is the same on every target.
+    [[nodiscard]] static uint64_t hashEntry(uint64_t hash, uint64_t nameHash, VariableType type,
+                                            const FieldWords &fieldWords)
+    {
+        const LittleEndian<uint64_t> NameHash = nameHash;
+        const auto Type = static_cast<uint8_t>(type);
+        hash = core::hash::fnvWithSeed(hash, reinterpret_cast<const uint8_t *>(&NameHash),
+                                       reinterpret_cast<const uint8_t *>(&NameHash + 1));
+        hash = core::hash::fnvWithSeed(hash, &Type, &Type + 1);
+        for (const uint32_t Word : fieldWords)
+        {
+            const LittleEndian<uint32_t> FieldWord = Word;
+            hash = core::hash::fnvWithSeed(hash, reinterpret_cast<const uint8_t *>(&FieldWord),
+                                           reinterpret_cast<const uint8_t *>(&FieldWord + 1));
         }
         return hash;
     }
 
-    const uint64_t settingsNamesHash = hashSettingsNames();
+    [[nodiscard]] static uint64_t finishValuesHash(typename Integrity::State state,
+                                                   uint32_t generation)
+    {
+        const LittleEndian<uint32_t> Generation = generation;
+        const auto GenerationBegin = reinterpret_cast<const uint8_t *>(&Generation);
+        state = Integrity::update(state, GenerationBegin, GenerationBegin + sizeof(Generation));
+        return Integrity::finish(state);
+    }
+
+    /// Members of EepromContent before the values.
+    struct SlotHeader
+    {
+        LittleEndian<uint64_t> settingsNamesHash = 0;
+        LittleEndian<uint64_t> settingsValuesHash = 0;
+        LittleEndian<uint32_t> magicString = 0;
+        LittleEndian<uint32_t> generation = 0;
+        LittleEndian<uint16_t> settingsEntryCount = 0;
+        LittleEndian<uint16_t> settingsValuesSize = 0;
+    };
+    static_assert(sizeof(SlotHeader) == HeaderSize);
+
+    [[nodiscard]] SlotHeader readSlotHeader(size_t offset)
+    {
+        SlotHeader header;
+        readMemory(offset, reinterpret_cast<uint8_t *>(&header), sizeof(header));
+        return header;
+    }
+
+    /// Streams the values of the newest valid slot, trying older ones if its values are corrupt.
+    /// @param generation set to the generation of the slot read
+    /// @param failure set to the furthest check any slot passed, if none is valid
+    /// @return true if values holds the content of a valid slot
+    bool streamNewestSlot(ValueImage &values, uint32_t &generation, LoadFailure &failure)
+    {
+        std::array<SlotHeader, SlotCount> headers;
+        std::array<bool, SlotCount> isCandidate{};
+        for (size_t slot = 0; slot < SlotCount; ++slot)
+        {
+            headers[slot] = readSlotHeader(getSlotOffset(slot));
+            isCandidate[slot] = headers[slot].magicString == Signature &&
+                                headers[slot].settingsNamesHash == settingsNamesHash;
+            if (headers[slot].magicString == Signature)
+            {
+                failure = std::max(failure, isCandidate[slot] ? LoadFailure::valuesHash
+                                                              : LoadFailure::namesHash);
+            }
+        }
+
+        for (size_t attempt = 0; attempt < SlotCount; ++attempt)
+        {
+            size_t newest = SlotCount;
+            for (size_t slot = 0; slot < SlotCount; ++slot)
+            {
+                // generation may wrap around
+                if (isCandidate[slot] &&
+                    (newest == SlotCount ||
+                     static_cast<int32_t>(headers[slot].generation - headers[newest].generation) >
+                         0))
+                {
+                    newest = slot;
+                }
+            }
+            if (newest == SlotCount)
+            {
+                return false;
+            }
+            isCandidate[newest] = false;
+            if (streamSlotValues(newest, headers[newest], values))
+            {
+                generation = headers[newest].generation;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Streams the values of the newest valid slot into values, decoding them unless saved in
+    /// NativeFormat.
+    bool streamValues(ValueArray &values, uint32_t &generation, LoadFailure &failure)
+    {
+        if constexpr (std::is_same_v<Format, NativeFormat>)
+        {
+            return streamNewestSlot(values, generation, failure);
+        }
+        else
+        {
+            ValueImage image{};
+            if (!streamNewestSlot(image, generation, failure))
+            {
+                return false;
+            }
+            for (size_t i = 0; i < SettingsCount; ++i)
+            {
+                Layout::setRaw(values, i, Serializer::getRaw(image, i));
+            }
+            return true;
+        }
+    }
+
+    bool streamSlotValues(size_t slot, const SlotHeader &header, ValueImage &values)
+    {
+        const auto Begin = reinterpret_cast<uint8_t *>(values.data());
+        auto state = Integrity::init();
+        for (size_t offset = 0; offset < sizeof(ValueImage); offset += StreamChunkSize)
+        {
+            const size_t Length = std::min(StreamChunkSize, sizeof(ValueImage) - offset);
+            readMemory(getSlotOffset(slot) + ValuesOffset + offset, Begin + offset, Length);
+            state = Integrity::update(state, Begin + offset, Begin + offset + Length);
+        }
+        return finishValuesHash(state, header.generation) == header.settingsValuesHash;
+    }
+
+    /// EEPROM range and generation of content saved with another settings table.
+    struct MigratedSlot
+    {
+        size_t offset = 0;
+        size_t size = 0;
+        uint32_t generation = 0;
+    };
+
+    /// Reads the newest valid slot saved with another settings table and maps its values by
+    /// NameHash to the current entries in one pass over the other table, using the NameIndex.
+    /// Entries unknown to the current table are dropped, new entries and ones with another type
+    /// keep their defaults. Bounds are checked by assignValues().
+    /// Reads the EEPROM in small chunks, blocking, also from within poll(). The other values are
+    /// verified by their settingsValuesHash first, then read straight into values while the other
+    /// table is verified by its settingsNamesHash. The field words of the Format in the other
+    /// table describe its values, e.g. the bounds of CompactFormat integers.
+    /// @param values current layout, valid on success
+    /// @param source slot the values were read from, valid on success
+    /// @return true if values were migrated
+    bool migrateContent(ValueArray &values, MigratedSlot &source)
+    {
+        static_assert(getOtherContentSize(SettingsCount, sizeof(ValueImage)) ==
+                      sizeof(EepromContent));
+
+        // counts aren't verified yet, but can't exceed the memory by much being 16 bit
+        const SlotHeader First = readSlotHeader(getSlotOffset(0));
+        const size_t EntryCount = First.settingsEntryCount;
+        const size_t ValuesSize = First.settingsValuesSize;
+        if (First.magicString != Signature || First.settingsNamesHash == settingsNamesHash)
+        {
+            return false;
+        }
+
+        // the other table decides about the slot size
+        const size_t ContentSize = getOtherContentSize(EntryCount, ValuesSize);
+        const size_t OtherSlotSize = getSlotSize(ContentSize);
+        std::array<SlotHeader, SlotCount> headers;
+        std::array<bool, SlotCount> isCandidate{};
+        for (size_t slot = 0; slot < SlotCount; ++slot)
+        {
+            const size_t Offset = MemoryOffset + slot * OtherSlotSize;
+            if (Offset + ContentSize > MemorySize<MemoryType>::SizeInBytes)
+            {
+                continue;
+            }
+            headers[slot] = slot == 0 ? First : readSlotHeader(Offset);
+            isCandidate[slot] = headers[slot].magicString == Signature &&
+                                headers[slot].settingsNamesHash == First.settingsNamesHash &&
+                                headers[slot].settingsEntryCount == EntryCount &&
+                                headers[slot].settingsValuesSize == ValuesSize;
+        }
+
+        for (size_t attempt = 0; attempt < SlotCount; ++attempt)
+        {
+            size_t newest = SlotCount;
+            for (size_t slot = 0; slot < SlotCount; ++slot)
+            {
+                // generation may wrap around
+                if (isCandidate[slot] &&
+                    (newest == SlotCount ||
+                     static_cast<int32_t>(headers[slot].generation - headers[newest].generation) >
+                         0))
+                {
+                    newest = slot;
+                }
+            }
+            if (newest == SlotCount)
+            {
+                return false;
+            }
+            isCandidate[newest] = false;
+
+            const size_t ValuesStart = MemoryOffset + newest * OtherSlotSize + HeaderSize;
+            values = Layout::createDefaultWords();
+            if (hasValidOtherValues(ValuesStart, ValuesSize, headers[newest]) &&
+                readOtherTable(ValuesStart, ValuesStart + ValuesSize, headers[newest], values))
+            {
+                source = MigratedSlot{MemoryOffset + newest * OtherSlotSize, ContentSize,
+                                      headers[newest].generation};
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Counts the booleans of a settings table saved with another one.
+    size_t countOtherBooleans(size_t typesStart, size_t entryCount)
+    {
+        size_t booleanCount = 0;
+        for (size_t first = 0; first < entryCount; first += TypesPerWord)
+        {
+            const size_t Count = std::min(TypesPerWord, entryCount - first);
+            LittleEndian<uint32_t> typeWord;
+            readMemory(typesStart + first / TypesPerWord * sizeof(typeWord),
+                       reinterpret_cast<uint8_t *>(&typeWord), sizeof(typeWord));
+            const uint32_t Types = typeWord;
+            for (size_t i = 0; i < Count; ++i)
+            {
+                booleanCount += static_cast<VariableType>((Types >> (2 * i)) & 3) ==
+                                VariableType::booleanType;
+            }
+        }
+        return booleanCount;
+    }
+
+    /// Reads a settings table saved with another one, finds its entries in the current one and
+    /// reads their values.
+    /// @param values current layout, defaults for entries not found
+    /// @return true if the table matches the names hash and sizes of header, values are
+    /// garbage otherwise
+    bool readOtherTable(size_t valuesStart, size_t tableStart, const SlotHeader &header,
+                        ValueArray &values)
+    {
+        const size_t EntryCount = header.settingsEntryCount;
+        const size_t ValuesSize = header.settingsValuesSize;
+        const size_t TypesStart = tableStart;
+        const size_t HashesStart =
+            TypesStart + (EntryCount + TypesPerWord - 1) / TypesPerWord * sizeof(uint32_t);
+        std::array<LittleEndian<uint32_t>, EntryWordCount * TypesPerWord> entryWords;
+        uint64_t hash = core::hash::HASH_SEED;
+        // NativeFormat: words of the non-booleans, followed by the ones of the booleans
+        size_t otherBooleanCount = 0;
+        if constexpr (std::is_same_v<Format, NativeFormat>)
+        {
+            otherBooleanCount = countOtherBooleans(TypesStart, EntryCount);
+            if (getNativeValuesSize(EntryCount, otherBooleanCount) != ValuesSize)
+            {
+                return false;
+            }
+        }
+        const size_t OtherNonBooleanCount = EntryCount - otherBooleanCount;
+        size_t nonBooleanCount = 0;
+        size_t booleanCount = 0;
+        // other formats: the fields in index order
+        size_t bitOffset = 0;
+
+        for (size_t first = 0; first < EntryCount; first += TypesPerWord)
+        {
+            const size_t Count = std::min(TypesPerWord, EntryCount - first);
+            LittleEndian<uint32_t> typeWord;
+            readMemory(TypesStart + first / TypesPerWord * sizeof(typeWord),
+                       reinterpret_cast<uint8_t *>(&typeWord), sizeof(typeWord));
+            const uint32_t Types = typeWord;
+            readMemory(HashesStart + first * EntryWordCount * sizeof(uint32_t),
+                       reinterpret_cast<uint8_t *>(entryWords.data()),
+                       Count * EntryWordCount * sizeof(uint32_t));
+
+            for (size_t i = 0; i < Count; ++i)
+            {
+                const auto Type = static_cast<VariableType>((Types >> (2 * i)) & 3);
+                const auto *Words = &entryWords[EntryWordCount * i];
+                const uint64_t NameHash = Words[0] | static_cast<uint64_t>(Words[1]) << 32;
+                FieldWords fieldWords{};
+                for (size_t w = 0; w < fieldWords.size(); ++w)
+                {
+                    fieldWords[w] = Words[2 + w];
+                }
+                hash = hashEntry(hash, NameHash, Type, fieldWords);
+
+                const auto [exists, index] =
+                    NameIndex<SettingsCount, entryArray>::findHash(NameHash);
+                const bool IsKnown = exists && Layout::Tables::getVariableType(index) == Type;
+                typename Layout::Raw_t raw = 0;
+                if constexpr (std::is_same_v<Format, NativeFormat>)
+                {
+                    const bool IsBoolean = Type == VariableType::booleanType;
+                    // position among the non-boolean or boolean entries of the other table
+                    const size_t Ordinal = IsBoolean ? booleanCount++ : nonBooleanCount++;
+                    // a table not matching its header may claim more entries than were saved
+                    if (!IsKnown || (IsBoolean ? booleanCount > otherBooleanCount
+                                               : nonBooleanCount > OtherNonBooleanCount))
+                    {
+                        continue;
+                    }
+                    const size_t Word =
+                        IsBoolean ? OtherNonBooleanCount + Ordinal / Layout::BitsPerWord : Ordinal;
+                    readMemory(valuesStart + Word * sizeof(raw),
+                               reinterpret_cast<uint8_t *>(&raw), sizeof(raw));
+                    if (IsBoolean)
+                    {
+                        raw = (raw >> (Ordinal % Layout::BitsPerWord)) & 1;
+                    }
+                }
+                else
+                {
+                    const size_t Width = fieldWords[1];
+                    if (Width > 8 * sizeof(raw))
+                    {
+                        return false;
+                    }
+                    const size_t FirstBit = bitOffset % 8;
+                    const size_t Bytes = Serializer::getFieldBytes(FirstBit, Width);
+                    bitOffset += Width;
+                    // a table not matching its header may claim more fields than were saved
+                    if (!IsKnown || bitOffset > 8 * ValuesSize)
+                    {
+                        continue;
+                    }
+                    std::array<uint8_t, sizeof(raw) + 1> fieldBytes{};
+                    readMemory(valuesStart + (bitOffset - Width) / 8, fieldBytes.data(), Bytes);
+                    raw = Serializer::getRaw(fieldBytes.data(), FirstBit, fieldWords);
+                }
+                Layout::setRaw(values, index, raw);
+            }
+        }
+        if constexpr (std::is_same_v<Format, NativeFormat>)
+        {
+            return hash == header.settingsNamesHash && booleanCount == otherBooleanCount;
+        }
+        else
+        {
+            return hash == header.settingsNamesHash &&
+                   std::max<size_t>((bitOffset + 7) / 8, 1) == ValuesSize;
+        }
+    }
+
+    bool hasValidOtherValues(size_t valuesStart, size_t valuesSize, const SlotHeader &header)
+    {
+        std::array<uint8_t, StreamChunkSize> chunk;
+        auto state = Integrity::init();
+        for (size_t offset = 0; offset < valuesSize; offset += StreamChunkSize)
+        {
+            const size_t Length = std::min(StreamChunkSize, valuesSize - offset);
+            const uint8_t *const Bytes = viewMemory(valuesStart + offset, chunk.data(), Length);
+            state = Integrity::update(state, Bytes, Bytes + Length);
+        }
+        return finishValuesHash(state, header.generation) == header.settingsValuesHash;
+    }
+
+    /// Picks the newest valid slot of a freshly read image, nothing pending.
+    void selectNewestSlot()
+    {
+        isContentCached = true;
+        hasValidSlot = false;
+        for (auto &writer : pageWriters)
+        {
+            writer.clear();
+        }
+
+        for (size_t slot = 0; slot < SlotCount; ++slot)
+        {
+            if (!isSlotValid(slot))
+            {
+                continue;
+            }
+            // generation may wrap around
+            const auto Age = static_cast<int32_t>(slotContent(activeSlot).generation -
+                                                  slotContent(slot).generation);
+            if (!hasValidSlot || Age < 0)
+            {
+                activeSlot = slot;
+                hasValidSlot = true;
+            }
+        }
+    }
+
+    /// Captures the values of SettingsContainer in the next slot image. Pages differing from
+    /// the EEPROM content get pending. Nothing gets pending if the newest saved content already
+    /// contains all values.
+    /// @param onlyDirty compare dirty entries only instead of all values
+    void snapshotValues(bool onlyDirty)
+    {
+        ValueArray values;
+        settings.copyValuesTo(values);
+
+        auto &newestContent = slotContent(activeSlot);
+        bool isChanged = !hasValidSlot;
+        if (onlyDirty)
+        {
+            settings.getDirtyEntries().forEach(
+                [&](size_t index)
+                {
+                    isChanged |= Serializer::getRaw(newestContent.settingsValues, index) !=
+                                 Layout::getRaw(values, index);
+                });
+        }
+        else
+        {
+            for (size_t i = 0; i < SettingsCount && !isChanged; ++i)
+            {
+                isChanged = Serializer::getRaw(newestContent.settingsValues, i) !=
+                            Layout::getRaw(values, i);
+            }
+        }
+        settings.clearDirtyEntries();
+        if (!isChanged)
+        {
+            return;
+        }
+
+        // without valid content the generations are garbage, start over with the first slot
+        if (hasValidSlot)
+        {
+            writeSnapshot(values, (activeSlot + 1) % SlotCount, newestContent.generation + 1);
+        }
+        else
+        {
+            writeSnapshot(values, 0, 1);
+        }
+    }
+
+    /// Captures the migrated values of SettingsContainer in a slot not overlapping their source,
+    /// so the source stays loadable until the migrated content is complete. The generation
+    /// continues the one of the source. Falls back to the first slot if every slot overlaps the
+    /// source, e.g. with a single slot.
+    void snapshotMigratedValues(const MigratedSlot &source)
+    {
+        ValueArray values;
+        settings.copyValuesTo(values);
+        settings.clearDirtyEntries();
+
+        size_t targetSlot = 0;
+        for (size_t slot = 0; slot < SlotCount; ++slot)
+        {
+            if (getSlotOffset(slot) + sizeof(EepromContent) <= source.offset ||
+                getSlotOffset(slot) >= source.offset + source.size)
+            {
+                targetSlot = slot;
+                break;
+            }
+        }
+        writeSnapshot(values, targetSlot, source.generation + 1);
+    }
+
+    /// Makes the image of slot the newest content, pages differing from EEPROM get pending.
+    void writeSnapshot(const ValueArray &values, size_t slot, uint32_t generation)
+    {
+        ValueImage image{};
+        Serializer::serialize(values, image);
+        updateValues(slot, image);
+        updateHeader(slot, generation);
+
+        if (!isContentCached)
+        {
+            // unknown EEPROM content, every page has to be written
+            pageWriters[slot].markAll();
+        }
+        activeSlot = slot;
+        hasValidSlot = true;
+    }
+
+    /// Copies values to a slot image, pages of differing bytes get pending.
+    void updateValues(size_t slot, const ValueImage &image)
+    {
+        const auto Source = reinterpret_cast<const uint8_t *>(image.data());
+        auto target = reinterpret_cast<uint8_t *>(slotContent(slot).settingsValues.data());
+        for (size_t i = 0; i < sizeof(ValueImage); ++i)
+        {
+            if (target[i] != Source[i])
+            {
+                target[i] = Source[i];
+                pageWriters[slot].markChanged(ValuesOffset + i, 1);
+            }
+        }
+    }
+
+    /// Finishes a slot image with a fresh header, its page gets pending when it differs.
+    void updateHeader(size_t slot, uint32_t generation)
+    {
+        auto &content = slotContent(slot);
+        const uint64_t ValuesHash = hashSettingsValues(content.settingsValues, generation);
+        if (content.magicString != Signature ||
+            content.settingsNamesHash != settingsNamesHash ||
+            content.settingsValuesHash != ValuesHash || content.generation != generation)
+        {
+            content.magicString = Signature;
+            content.settingsNamesHash = settingsNamesHash;
+            content.settingsValuesHash = ValuesHash;
+            content.generation = generation;
+            pageWriters[slot].markChanged(0, ValuesOffset);
+        }
+        if (!hasCurrentTable(slot))
+        {
+            content.settingsEntryCount = SettingsCount;
+            content.settingsValuesSize = sizeof(ValueImage);
+            isTableCurrent[slot] = true;
+            pageWriters[slot].markChanged(0, ValuesOffset);
+            pageWriters[slot].markChanged(TableOffset, sizeof(EepromContent) - TableOffset);
+        }
+    }
 };
 
-} // namespace settings
\ No newline at end of file
+} // namespace settings
@@ -0,0 +1,395 @@
+#pragma once
+
+#include "settings-manager/Integrity.hpp"
+#include "settings-manager/IoStatistics.hpp"
+#include "settings-manager/MemoryTraits.hpp"
+#include "settings-manager/SettingsContainer.hpp"
+#include "settings-manager/SettingsIO.hpp"
+
+#include <core/SafeAssert.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace settings
+{
+
+/// Log structured alternative to SettingsIO, for settings which are tuned frequently at runtime.
+/// A save appends one compact record per changed value to a journal, instead of rewriting the
+/// whole EepromContent. Loading replays the journal on top of the last snapshot. A full journal
+/// is compacted into a new snapshot, written to the A/B slots of SettingsIO<..., 2> through the
+/// scratch image given by the caller, so no snapshot is held in RAM between operations.
+///
+/// The journal is a ring of records. Each generation starts with a marker record where the journal
+/// of the previous one ended, so compactions don't restart at the first page and every page gets
+/// its share of the writes.
+/// Records are tied to their position in the ring and to the generation of their snapshot.
+/// So a compaction invalidates all old records without erasing them and the journal ends at the
+/// first record not passing its check, e.g. a torn one. Appending continues there.
+///
+/// EEPROM layout from MemoryOffset: snapshot slot A, snapshot slot B, journal.
+/// @tparam SettingsCount
+/// @tparam entryArray
+/// @tparam MemoryType
+/// @tparam JournalPageCount EEPROM pages used for the journal
+/// @tparam Integrity snapshot values hash policy, see Integrity.hpp
+/// @tparam Statistics EEPROM transaction counters, see IoStatistics.hpp. A private base, so
+/// NoStatistics takes no space.
+template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray,
+          class MemoryType, size_t JournalPageCount = 4, class Integrity = FnvIntegrity,
+          class Statistics = NoStatistics>
+class SettingsJournal : private Statistics
+{
+public:
+    using Container = SettingsContainer<SettingsCount, entryArray>;
+    using SnapshotIO = SettingsIO<SettingsCount, entryArray, MemoryType, 2, Integrity,
+                                  NativeFormat, ScratchImage, Statistics>;
+    using ImageBuffer = typename SnapshotIO::ImageBuffer;
+    using ValueArray = typename Container::ValueArray;
+    using Layout = typename Container::Layout;
+
+    static_assert(JournalPageCount > 0);
+    static_assert(SettingsCount < std::numeric_limits<uint16_t>::max());
+
+    /// @param scratch holds the snapshots while one is read or written, see ScratchImage
+    SettingsJournal(MemoryType &eeprom, Container &settings, ImageBuffer &scratch)
+        : eeprom(eeprom),     //
+          settings(settings), //
+          snapshotIO(eeprom, settings, scratch)
+    {
+    }
+    virtual ~SettingsJournal() = default;
+
+    /// One persisted value change. Eight bytes, a page holds a whole number of records.
+    struct Record
+    {
+        uint16_t index = 0;
+        /// CRC-16/CCITT of generation, journal position, index and value
+        uint16_t check = 0;
+        /// raw value, see ValueLayout
+        typename Layout::Raw_t value = 0;
+    };
+    static_assert(sizeof(Record) == 8);
+
+    /// index of the record starting the journal of a generation
+    static constexpr uint16_t MarkerIndex = std::numeric_limits<uint16_t>::max();
+
+    static constexpr size_t PageSize = MemoryTraits<MemoryType>::PageSize;
+    static_assert(PageSize % sizeof(Record) == 0);
+    static constexpr size_t RecordsPerPage = PageSize / sizeof(Record);
+    static constexpr size_t RecordCount = JournalPageCount * RecordsPerPage;
+    /// value changes a journal takes, the marker uses one record
+    static constexpr size_t Capacity = RecordCount - 1;
+    static_assert(RecordCount <= std::numeric_limits<uint16_t>::max());
+
+    static constexpr size_t JournalOffset = SnapshotIO::getSlotOffset(2);
+    static_assert(JournalOffset % PageSize == 0);
+
+    /// EEPROM bytes used from MemoryOffset on
+    static constexpr size_t RequiredMemorySize =
+        JournalOffset - SnapshotIO::MemoryOffset + RecordCount * sizeof(Record);
+
+    /// Loads settings from EEPROM. Blocking. Updates SettingsContainer with the newest snapshot
+    /// and all journal records on top of it.
+    /// Discards EEPROM content and writes defaults on failure.
+    /// @return true on success, false otherwise
+    virtual bool loadSettings()
+    {
+        LoadFailure failure = LoadFailure::signature;
+        const bool IsValid = readPersistedValues(failure);
+        if (!IsValid)
+        {
+            statistics().countLoadFailure(failure);
+            settings.resetAllToDefault();
+        }
+        // out of range values are reset to default and written back
+        else if (settings.assignValues(persistedValues) > 0)
+        {
+            statistics().countOutOfRangeLoad();
+        }
+        statistics().countLoad(IsValid);
+        saveValues(false);
+        return IsValid;
+    }
+
+    /// Appends all values differing from the persisted ones to the journal. Blocking.
+    /// Compacts when the journal can't take all of them.
+    virtual void saveSettings()
+    {
+        statistics().beginSave();
+        saveValues(false);
+        statistics().endSave();
+    }
+
+    /// Like saveSettings(), but compares dirty entries of the SettingsContainer only.
+    virtual void saveChangedSettings()
+    {
+        statistics().beginSave();
+        saveValues(true);
+        statistics().endSave();
+    }
+
+    /// Records appended since the last compaction, without the marker.
+    [[nodiscard]] size_t getJournalLength() const
+    {
+        return journalLength;
+    }
+
+    /// Ring position of the marker starting the journal.
+    [[nodiscard]] size_t getJournalStart() const
+    {
+        return journalStart;
+    }
+
+    /// Generation of the snapshot the journal builds upon.
+    [[nodiscard]] uint32_t getGeneration() const
+    {
+        return generation;
+    }
+
+    /// Journal transactions so far: loads, saves, record reads and writes. Empty with
+    /// NoStatistics.
+    [[nodiscard]] const Statistics &getStatistics() const
+    {
+        return *this;
+    }
+
+    /// Snapshot transactions so far, see SettingsIO::getStatistics().
+    [[nodiscard]] const Statistics &getSnapshotStatistics() const
+    {
+        return snapshotIO.getStatistics();
+    }
+
+    [[nodiscard]] static constexpr size_t getRecordOffset(size_t position)
+    {
+        return JournalOffset + position * sizeof(Record);
+    }
+
+    /// Check of a record, bound to the generation of its snapshot and its journal position.
+    /// A record of an older generation or moved to another position doesn't pass it.
+    [[nodiscard]] static uint16_t checkRecord(uint32_t generation, size_t position,
+                                              const Record &record)
+    {
+        std::array<uint8_t, sizeof(uint32_t) + sizeof(uint16_t) * 2 + sizeof(Record::value)>
+            bytes{};
+        const auto Position = static_cast<uint16_t>(position);
+        uint8_t *cursor = bytes.data();
+        std::memcpy(cursor, &generation, sizeof(generation));
+        cursor += sizeof(generation);
+        std::memcpy(cursor, &Position, sizeof(Position));
+        cursor += sizeof(Position);
+        std::memcpy(cursor, &record.index, sizeof(record.index));
+        cursor += sizeof(record.index);
+        std::memcpy(cursor, &record.value, sizeof(record.value));
+
+        const auto State = Crc16Integrity::update(Crc16Integrity::init(), bytes.data(),
+                                                  bytes.data() + bytes.size());
+        return static_cast<uint16_t>(Crc16Integrity::finish(State));
+    }
+
+private:
+    using RecordPage = std::array<Record, RecordsPerPage>;
+
+    MemoryType &eeprom;
+    Container &settings;
+    SnapshotIO snapshotIO;
+
+    /// values as persisted by the newest snapshot and the journal
+    ValueArray persistedValues{};
+    uint32_t generation = 0;
+    size_t journalStart = 0;
+    size_t journalLength = 0;
+
+    /// persistedValues, generation, journalStart and journalLength reflect the EEPROM content
+    bool isPersistedStateKnown = false;
+    bool hasValidSnapshot = false;
+    /// the marker of generation is written at journalStart
+    bool hasMarker = false;
+
+    [[nodiscard]] Statistics &statistics()
+    {
+        return *this;
+    }
+
+    /// Ring position of the record following length records of the journal.
+    [[nodiscard]] size_t getPosition(size_t length) const
+    {
+        return (journalStart + 1 + length) % RecordCount;
+    }
+
+    void readPage(size_t page, RecordPage &records)
+    {
+        eeprom.read(getRecordOffset(page * RecordsPerPage),
+                    reinterpret_cast<uint8_t *>(records.data()), PageSize);
+        statistics().countRead(PageSize);
+    }
+
+    /// Reads the newest valid snapshot and replays the journal on top of it.
+    /// Doesn't touch the SettingsContainer.
+    /// @param failure set to the furthest check any snapshot passed, if none is valid
+    /// @return true if a valid snapshot was found
+    bool readPersistedValues(LoadFailure &failure)
+    {
+        isPersistedStateKnown = true;
+        journalStart = 0;
+        journalLength = 0;
+        hasMarker = false;
+        hasValidSnapshot = snapshotIO.readSavedValues(persistedValues, generation, failure);
+        if (!hasValidSnapshot)
+        {
+            return false;
+        }
+
+        RecordPage records;
+        size_t loadedPage = 0;
+        for (size_t page = 0; page < JournalPageCount && !hasMarker; ++page)
+        {
+            readPage(page, records);
+            loadedPage = page;
+            for (size_t i = 0; i < RecordsPerPage && !hasMarker; ++i)
+            {
+                const size_t Position = page * RecordsPerPage + i;
+                if (records[i].index == MarkerIndex &&
+                    records[i].check == checkRecord(generation, Position, records[i]))
+                {
+                    journalStart = Position;
+                    hasMarker = true;
+                }
+            }
+        }
+        // without a marker the compaction was interrupted before it, the journal is empty
+
+        for (size_t length = 0; hasMarker && length < Capacity; ++length)
+        {
+            const size_t Position = getPosition(length);
+            if (Position / RecordsPerPage != loadedPage)
+            {
+                loadedPage = Position / RecordsPerPage;
+                readPage(loadedPage, records);
+            }
+            const Record &Next = records[Position % RecordsPerPage];
+            if (!isRecordValid(Position, Next))
+            {
+                break;
+            }
+            Layout::setRaw(persistedValues, Next.index, Next.value);
+            journalLength++;
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool isRecordValid(size_t position, const Record &record) const
+    {
+        return record.index < SettingsCount &&
+               record.check == checkRecord(generation, position, record);
+    }
+
+    void saveValues(bool onlyDirty)
+    {
+        if (!isPersistedStateKnown)
+        {
+            LoadFailure failure = LoadFailure::signature;
+            readPersistedValues(failure);
+        }
+
+        ValueArray values;
+        settings.copyValuesTo(values);
+
+        IndexSet<SettingsCount> changedEntries;
+        const auto checkValue = [&](size_t index)
+        {
+            if (Layout::getRaw(persistedValues, index) != Layout::getRaw(values, index))
+            {
+                changedEntries.set(index);
+            }
+        };
+        if (onlyDirty)
+        {
+            settings.getDirtyEntries().forEach(checkValue);
+        }
+        else
+        {
+            for (size_t i = 0; i < SettingsCount; ++i)
+            {
+                checkValue(i);
+            }
+        }
+        settings.clearDirtyEntries();
+
+        if (!hasValidSnapshot || changedEntries.count() > Capacity - journalLength)
+        {
+            compact(values);
+        }
+        else
+        {
+            appendRecords(values, changedEntries);
+        }
+    }
+
+    /// Appends one record per changed entry, records sharing a page are written at once.
+    /// A journal without its marker gets it first.
+    void appendRecords(const ValueArray &values, const IndexSet<SettingsCount> &changedEntries)
+    {
+        RecordPage pageRecords;
+        size_t firstPosition = hasMarker ? getPosition(journalLength) : journalStart;
+        size_t recordCount = 0;
+
+        const auto flush = [&]()
+        {
+            if (recordCount > 0)
+            {
+                const size_t Length = recordCount * sizeof(Record);
+                eeprom.write(getRecordOffset(firstPosition),
+                             reinterpret_cast<const uint8_t *>(pageRecords.data()), Length);
+                statistics().countPageWrite(Length);
+            }
+            firstPosition = getPosition(journalLength);
+            recordCount = 0;
+        };
+        // the ring wraps at a page boundary, so a page ends before position 0
+        const auto append = [&](size_t position, Record record)
+        {
+            record.check = checkRecord(generation, position, record);
+            pageRecords[recordCount++] = record;
+            if ((position + 1) % RecordsPerPage == 0)
+            {
+                flush();
+            }
+        };
+
+        if (!hasMarker)
+        {
+            hasMarker = true;
+            append(journalStart, Record{MarkerIndex, 0, 0});
+        }
+        changedEntries.forEach(
+            [&](size_t index)
+            {
+                const size_t Position = getPosition(journalLength);
+                const auto Value = Layout::getRaw(values, index);
+                Layout::setRaw(persistedValues, index, Value);
+                journalLength++;
+                append(Position, Record{static_cast<uint16_t>(index), 0, Value});
+            });
+        flush();
+    }
+
+    /// Writes all values as a new snapshot to the slot not holding the newest one.
+    /// The new generation invalidates all records, its journal starts where the old one ended.
+    void compact(const ValueArray &values)
+    {
+        const size_t End = hasMarker ? getPosition(journalLength) : journalStart;
+        generation = snapshotIO.saveNewGeneration();
+        persistedValues = values;
+        journalStart = End;
+        journalLength = 0;
+        hasValidSnapshot = true;
+        hasMarker = false;
+        appendRecords(values, IndexSet<SettingsCount>{});
+    }
+};
+
+} // namespace settings
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "settings-manager/NameIndex.hpp"
+#include "settings-manager/SettingsContainer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+
+namespace settings
+{
+
+/// Result of SettingsText::readText().
+struct TextImportResult
+{
+    size_t lineCount = 0;
+    size_t assignedCount = 0;
+    size_t unknownNameCount = 0;
+    size_t invalidValueCount = 0;
+    /// 1 based line of the first unknown name or invalid value, 0 without errors
+    size_t firstErrorLine = 0;
+
+    [[nodiscard]] bool isValid() const
+    {
+        return unknownNameCount == 0 && invalidValueCount == 0;
+    }
+};
+
+/// Text form of all values, for host tools inspecting and creating EEPROM images.
+/// Text is one "name=value" per line: integers in decimal, booleans as true / false and reals
+/// in their shortest form reading back to the same float. JSON is a single object of the same
+/// values, reals without a JSON number, infinity and NaN, are strings like "inf" and "nan".
+/// Values may be given as ValueArray too, e.g. as saved in EEPROM, bounds aren't checked then.
+/// @tparam SettingsCount
+/// @tparam entryArray
+template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray>
+class SettingsText
+{
+public:
+    using Container = SettingsContainer<SettingsCount, entryArray>;
+    using Layout = typename Container::Layout;
+    using Tables = typename Layout::Tables;
+
+    /// Appends all values as "name=value" lines in index order.
+    static void appendText(const Container &settings, std::string &text)
+    {
+        typename Container::ValueArray values;
+        settings.copyValuesTo(values);
+        appendText(values, text);
+    }
+
+    static void appendText(const typename Container::ValueArray &values, std::string &text)
+    {
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            text.append(Tables::getName(i));
+            text.push_back('=');
+            appendValue(i, Layout::getRaw(values, i), false, text);
+            text.push_back('\n');
+        }
+    }
+
+    /// Appends all values as a JSON object, names as keys.
+    static void appendJson(const Container &settings, std::string &text)
+    {
+        typename Container::ValueArray values;
+        settings.copyValuesTo(values);
+        appendJson(values, text);
+    }
+
+    static void appendJson(const typename Container::ValueArray &values, std::string &text)
+    {
+        text.push_back('{');
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            text.append(i == 0 ? "\n  \"" : ",\n  \"");
+            appendEscaped(Tables::getName(i), text);
+            text.append("\": ");
+            appendValue(i, Layout::getRaw(values, i), true, text);
+        }
+        text.append("\n}");
+    }
+
+    /// Assigns the values of "name=value" lines in a single pass, one NameIndex lookup per line.
+    /// Empty lines and lines starting with '#' are skipped, whitespace around names and values is
+    /// ignored. Settings not mentioned keep their value. Lines with unknown names or values out of
+    /// bounds are counted and skipped, all others are assigned at once.
+    static TextImportResult readText(std::string_view text, Container &settings)
+    {
+        TextImportResult result;
+        typename Container::ValueArray values;
+        settings.copyValuesTo(values);
+
+        while (!text.empty())
+        {
+            const size_t LineEnd = std::min(text.find('\n'), text.size());
+            const std::string_view Line = trim(text.substr(0, LineEnd));
+            text.remove_prefix(std::min(LineEnd + 1, text.size()));
+            ++result.lineCount;
+            if (Line.empty() || Line.front() == '#')
+            {
+                continue;
+            }
+
+            const size_t Separator = Line.find('=');
+            const auto [exists, index] = Separator == std::string_view::npos
+                                             ? std::make_tuple(false, size_t{0})
+                                             : Index::find(trim(Line.substr(0, Separator)));
+            if (!exists)
+            {
+                ++result.unknownNameCount;
+                noteError(result);
+                continue;
+            }
+
+            const auto [isValid, raw] = parseValue(index, trim(Line.substr(Separator + 1)));
+            if (!isValid)
+            {
+                ++result.invalidValueCount;
+                noteError(result);
+                continue;
+            }
+            Layout::setRaw(values, index, raw);
+            ++result.assignedCount;
+        }
+
+        settings.assignValues(values);
+        return result;
+    }
+
+    /// Appends a string escaped for a JSON string literal, control characters included.
+    static void appendEscaped(std::string_view string, std::string &text)
+    {
+        constexpr char Hex[] = "0123456789abcdef";
+        for (const char Character : string)
+        {
+            const auto Code = static_cast<unsigned char>(Character);
+            switch (Character)
+            {
+            case '"':
+            case '\\':
+                text.push_back('\\');
+                text.push_back(Character);
+                break;
+            case '\n':
+                text.append("\\n");
+                break;
+            case '\t':
+                text.append("\\t");
+                break;
+            case '\r':
+                text.append("\\r");
+                break;
+            default:
+                if (Code < 0x20)
+                {
+                    text.append("\\u00");
+                    text.push_back(Hex[Code >> 4]);
+                    text.push_back(Hex[Code & 0xF]);
+                }
+                else
+                {
+                    text.push_back(Character);
+                }
+                break;
+            }
+        }
+    }
+
+private:
+    using Index = NameIndex<SettingsCount, entryArray>;
+    using Raw_t = typename Layout::Raw_t;
+
+    static void appendValue(size_t index, Raw_t raw, bool isJson, std::string &text)
+    {
+        // shortest round trip of a float takes up to 15 characters, int32_t up to 11
+        char buffer[32];
+        std::to_chars_result result{};
+        switch (Tables::getVariableType(index))
+        {
+        case VariableType::booleanType:
+            text.append(raw != 0 ? "true" : "false");
+            return;
+        case VariableType::integerType:
+            result = std::to_chars(std::begin(buffer), std::end(buffer), static_cast<int32_t>(raw));
+            break;
+        default:
+        {
+            const auto Real = __builtin_bit_cast(SettingsValue_t, raw);
+            result = std::to_chars(std::begin(buffer), std::end(buffer), Real);
+            if (isJson && !std::isfinite(Real))
+            {
+                text.push_back('"');
+                text.append(buffer, result.ptr);
+                text.push_back('"');
+                return;
+            }
+            break;
+        }
+        }
+        text.append(buffer, result.ptr);
+    }
+
+    /// @return validity, including bounds, and raw value
+    [[nodiscard]] static std::tuple<bool, Raw_t> parseValue(size_t index, std::string_view value)
+    {
+        const VariableType Type = Tables::getVariableType(index);
+        if (Type == VariableType::booleanType && (value == "true" || value == "false"))
+        {
+            return std::make_tuple(true, value == "true" ? 1 : 0);
+        }
+
+        const char *const End = value.data() + value.size();
+        if (Type == VariableType::integerType)
+        {
+            // exact beyond the float mantissa, decimal digits only
+            int64_t integer = 0;
+            const auto [end, error] = std::from_chars(value.data(), End, integer);
+            if (value.empty() || error != std::errc{} || end != End)
+            {
+                return std::make_tuple(false, 0);
+            }
+            return Layout::encode(index, integer);
+        }
+
+        double real = 0;
+        const auto [end, error] = std::from_chars(value.data(), End, real);
+        if (value.empty() || error != std::errc{} || end != End || !std::isfinite(real))
+        {
+            return std::make_tuple(false, 0);
+        }
+        return Layout::encode(index, real);
+    }
+
+    [[nodiscard]] static std::string_view trim(std::string_view text)
+    {
+        constexpr std::string_view Whitespace = " \t\r";
+        const size_t Begin = text.find_first_not_of(Whitespace);
+        if (Begin == std::string_view::npos)
+        {
+            return {};
+        }
+        return text.substr(Begin, text.find_last_not_of(Whitespace) - Begin + 1);
+    }
+
+    static void noteError(TextImportResult &result)
+    {
+        if (result.firstErrorLine == 0)
+        {
+            result.firstErrorLine = result.lineCount;
+        }
+    }
+};
+
+} // namespace settings
@@ -3,44 +3,244 @@
 #include <core/SafeAssert.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <tuple>
 
 namespace settings
 {
 
+/// Indices of changed settings of one SettingsContainer, independent of the settings count.
+/// Refers to the words of an IndexSet, which has to outlive it.
+class SettingsChanges
+{
+public:
+    static constexpr size_t BitsPerWord = 32;
+
+    /// @param container identity of the changed container, see SettingsContainer::getIdentity()
+    SettingsChanges(const void *container, const uint32_t *words, size_t wordCount)
+        : container(container), words(words), wordCount(wordCount)
+    {
+    }
+
+    template <class IndexSetType>
+    SettingsChanges(const void *container, const IndexSetType &indexSet)
+        : SettingsChanges(container, indexSet.getWords().data(), indexSet.getWords().size())
+    {
+    }
+
+    /// True if the changes belong to the container of identity, indices of other containers
+    /// mean other settings.
+    [[nodiscard]] bool isOf(const void *identity) const
+    {
+        return container == identity;
+    }
+
+    [[nodiscard]] bool test(size_t index) const
+    {
+        return index / BitsPerWord < wordCount &&
+               (words[index / BitsPerWord] & (1UL << (index % BitsPerWord))) != 0;
+    }
+
+    /// True if any index of mask is changed. Costs one AND per word.
+    [[nodiscard]] bool intersects(const uint32_t *mask, size_t maskWordCount) const
+    {
+        const size_t Count = maskWordCount < wordCount ? maskWordCount : wordCount;
+        for (size_t w = 0; w < Count; ++w)
+        {
+            if ((words[w] & mask[w]) != 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const void *container;
+    const uint32_t *words;
+    size_t wordCount;
+};
+
 /// Inherit from this class to automatically subscribe to settings changes and get
 /// onSettingsUpdate() called.
+/// Instances are linked into an intrusive list, so there is no limit on their number and
+/// registering / unregistering costs O(1) without any allocation.
+/// onSettingsUpdate() may destroy any instance, also others than itself, and notify again.
 class SettingsUser
 {
 public:
     SettingsUser()
     {
-        if (registeredInstancesCount == MaxInstances)
-            SafeAssert(false); // maximum number of instances reached
-
-        index = registeredInstancesCount++;
-        registeredInstances[index] = this;
+        registerInstance();
+    }
+    SettingsUser(const SettingsUser &)
+    {
+        registerInstance();
     }
-    ~SettingsUser()
+    SettingsUser &operator=(const SettingsUser &)
     {
-        registeredInstances[index] = nullptr;
+        // registration belongs to the instance, nothing to copy
+        return *this;
+    }
+    virtual ~SettingsUser()
+    {
+        unregisterInstance();
     }
 
     /// User implemented function that queries relevant settings and save their own copy.
     /// Don't forget to call at least once to receive settings.
     virtual void onSettingsUpdate() = 0;
 
+    /// Whether onSettingsUpdate() has to be called for changes. Every change affects a plain
+    /// SettingsUser, see SettingsSubscriber for users depending on some settings only.
+    [[nodiscard]] virtual bool isAffectedBy(const SettingsChanges &) const
+    {
+        return true;
+    }
+
     /// Notifies all registered instances that settings changed.
     static void notifySettingsUpdate()
     {
-        for (uint8_t i = 0; i < registeredInstancesCount; ++i)
-            registeredInstances[i]->onSettingsUpdate();
+        forEachInstance([](SettingsUser &user) { user.onSettingsUpdate(); });
+    }
+
+    /// Notifies registered instances affected by changes only.
+    static void notifySettingsUpdate(const SettingsChanges &changes)
+    {
+        forEachInstance(
+            [&changes](SettingsUser &user)
+            {
+                if (user.isAffectedBy(changes))
+                {
+                    user.onSettingsUpdate();
+                }
+            });
+    }
+
+    [[nodiscard]] static size_t getRegisteredInstanceCount()
+    {
+        return registeredInstancesCount;
     }
 
 private:
-    uint8_t index;
-    static constexpr uint8_t MaxInstances = 16;
-    inline static std::array<SettingsUser *, MaxInstances> registeredInstances{nullptr};
-    inline static uint8_t registeredInstancesCount{0};
+    /// Instance a running notification calls next. Notifications started from within
+    /// onSettingsUpdate() stack their cursors.
+    struct Cursor
+    {
+        SettingsUser *next;
+        Cursor *outer;
+    };
+
+    SettingsUser *previous = nullptr;
+    SettingsUser *next = nullptr;
+    inline static SettingsUser *firstInstance{nullptr};
+    inline static SettingsUser *lastInstance{nullptr};
+    inline static size_t registeredInstancesCount{0};
+    inline static Cursor *innermostCursor{nullptr};
+
+    void registerInstance()
+    {
+        previous = lastInstance;
+        if (lastInstance != nullptr)
+        {
+            lastInstance->next = this;
+        }
+        else
+        {
+            firstInstance = this;
+        }
+        lastInstance = this;
+        registeredInstancesCount++;
+    }
+
+    void unregisterInstance()
+    {
+        // running notifications skip this instance
+        for (Cursor *cursor = innermostCursor; cursor != nullptr; cursor = cursor->outer)
+        {
+            if (cursor->next == this)
+            {
+                cursor->next = next;
+            }
+        }
+        if (previous != nullptr)
+        {
+            previous->next = next;
+        }
+        else
+        {
+            SafeAssert(firstInstance == this);
+            firstInstance = next;
+        }
+        if (next != nullptr)
+        {
+            next->previous = previous;
+        }
+        else
+        {
+            SafeAssert(lastInstance == this);
+            lastInstance = previous;
+        }
+        registeredInstancesCount--;
+    }
+
+    /// In order of registration, instances registered from within are called as well.
+    /// The next instance is kept in a cursor, which unregistering instances move past
+    /// themselves, so function may destroy any instance.
+    template <typename Function>
+    static void forEachInstance(Function &&function)
+    {
+        Cursor cursor{firstInstance, innermostCursor};
+        innermostCursor = &cursor;
+        while (SettingsUser *const User = cursor.next)
+        {
+            cursor.next = User->next;
+            function(*User);
+        }
+        innermostCursor = cursor.outer;
+    }
+};
+
+/// SettingsUser depending on the settings given by name only. Its onSettingsUpdate() is called
+/// for changes of these settings only, the dependency mask is built at compile time.
+/// @tparam Container SettingsContainer the names belong to
+/// @tparam names settings read by onSettingsUpdate()
+template <class Container, const std::string_view &... names>
+class SettingsSubscriber : public SettingsUser
+{
+public:
+    static_assert(sizeof...(names) > 0, "subscribe to at least one setting");
+
+    /// one bit per setting, like the IndexSet of the changes
+    static constexpr size_t WordCount =
+        (Container::EntryCount + SettingsChanges::BitsPerWord - 1) / SettingsChanges::BitsPerWord;
+
+    [[nodiscard]] bool isAffectedBy(const SettingsChanges &changes) const override
+    {
+        return changes.isOf(Container::getIdentity()) &&
+               changes.intersects(DependencyMask.data(), DependencyMask.size());
+    }
+
+    [[nodiscard]] static constexpr const std::array<uint32_t, WordCount> &getDependencyMask()
+    {
+        return DependencyMask;
+    }
+
+private:
+    [[nodiscard]] static constexpr std::array<uint32_t, WordCount> createDependencyMask()
+    {
+        std::array<uint32_t, WordCount> mask{};
+        for (const size_t Index : {Container::template getIndex<names>()...})
+        {
+            mask[Index / SettingsChanges::BitsPerWord] |=
+                1UL << (Index % SettingsChanges::BitsPerWord);
+        }
+        return mask;
+    }
+
+    static constexpr std::array<uint32_t, WordCount> DependencyMask = createDependencyMask();
 };
-} // namespace settings
\ No newline at end of file
+} // namespace settings
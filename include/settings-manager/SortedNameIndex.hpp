@@ -0,0 +1,138 @@
+#pragma once
+
+#include "settings-manager/EntryTables.hpp"
+#include "settings-manager/SettingsEntry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace settings
+{
+
+/// Compile time generated lexicographic order of the names of an entry array.
+/// Answers ordered queries on hierarchical names like "motor.pid.kp": all settings below a prefix
+/// in O(log N + k) and exact lookups in O(log N) string compares. Settings keep their index, the
+/// order is an extra array of indices.
+/// @tparam SettingsCount
+/// @tparam entryArray
+template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray>
+class SortedNameIndex
+{
+public:
+    /// Position in sorted order of the first name not less than name, SettingsCount if none.
+    [[nodiscard]] static constexpr size_t lowerBound(const std::string_view &name)
+    {
+        size_t first = 0;
+        size_t count = SettingsCount;
+        while (count > 0)
+        {
+            const size_t Step = count / 2;
+            if (nameAt(first + Step).compare(name) < 0)
+            {
+                first += Step + 1;
+                count -= Step + 1;
+            }
+            else
+            {
+                count = Step;
+            }
+        }
+        return first;
+    }
+
+    /// Index of the setting at a position in sorted order.
+    [[nodiscard]] static constexpr size_t getIndexAt(size_t position)
+    {
+        return Order[position];
+    }
+
+    /// Looks up a setting by name.
+    /// @return existence and index of the setting
+    [[nodiscard]] static constexpr std::tuple<bool, size_t> find(const std::string_view &name)
+    {
+        const size_t Position = lowerBound(name);
+        if (Position < SettingsCount && nameAt(Position).compare(name) == 0)
+        {
+            return std::make_tuple(true, getIndexAt(Position));
+        }
+        return std::make_tuple(false, 0);
+    }
+
+    /// Calls function(index) for every setting whose name starts with prefix, in name order.
+    /// An empty prefix visits all settings.
+    template <typename Function>
+    static constexpr void forEachWithPrefix(const std::string_view &prefix, Function &&function)
+    {
+        for (size_t position = lowerBound(prefix);
+             position < SettingsCount && hasPrefix(nameAt(position), prefix); ++position)
+        {
+            function(getIndexAt(position));
+        }
+    }
+
+    /// Number of settings whose name starts with prefix.
+    [[nodiscard]] static constexpr size_t countWithPrefix(const std::string_view &prefix)
+    {
+        size_t count = 0;
+        forEachWithPrefix(prefix, [&count](size_t) { ++count; });
+        return count;
+    }
+
+private:
+    using Tables = EntryTables<SettingsCount, entryArray>;
+    using Index_t = std::conditional_t<(SettingsCount <= std::numeric_limits<uint16_t>::max()),
+                                       uint16_t, uint32_t>;
+    using OrderArray = std::array<Index_t, SettingsCount == 0 ? 1 : SettingsCount>;
+
+    [[nodiscard]] static constexpr std::string_view nameAt(size_t position)
+    {
+        return Tables::getName(Order[position]);
+    }
+
+    [[nodiscard]] static constexpr bool hasPrefix(const std::string_view &name,
+                                                  const std::string_view &prefix)
+    {
+        return name.size() >= prefix.size() && name.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    /// Bottom up merge sort, stable and O(N log N) compares during constant evaluation.
+    [[nodiscard]] static constexpr OrderArray sort()
+    {
+        OrderArray order{};
+        OrderArray merged{};
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            order[i] = static_cast<Index_t>(i);
+        }
+
+        for (size_t width = 1; width < SettingsCount; width *= 2)
+        {
+            for (size_t begin = 0; begin < SettingsCount; begin += 2 * width)
+            {
+                const size_t Middle = std::min(begin + width, SettingsCount);
+                const size_t End = std::min(begin + 2 * width, SettingsCount);
+                size_t left = begin;
+                size_t right = Middle;
+                for (size_t out = begin; out < End; ++out)
+                {
+                    const bool TakeLeft =
+                        right >= End ||
+                        (left < Middle &&
+                         entryArray[order[right]].name.compare(entryArray[order[left]].name) >= 0);
+                    merged[out] = TakeLeft ? order[left++] : order[right++];
+                }
+            }
+            order = merged;
+        }
+        return order;
+    }
+
+    static constexpr OrderArray Order = sort();
+};
+
+} // namespace settings
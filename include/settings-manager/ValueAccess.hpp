@@ -0,0 +1,149 @@
+#pragma once
+
+#include "settings-manager/SettingsEntry.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace settings
+{
+
+/// Access policies of the value words of a SettingsContainer, chosen per entry array by
+/// ValueAccessOf. A policy provides the words:
+///     typename Policy::template Words<Raw_t, WordCount> words;
+///     Raw_t raw = words.load(w);
+///     words.beginWrite();
+///     words.store(w, raw);
+///     words.endWrite();
+///     words.readConsistent(read);     // read() loads several words
+///     uint32_t count = words.getWriteCount();
+
+/// Plain words, for values used by a single thread or guarded by the application. Default.
+struct PlainAccess
+{
+    template <class Raw_t, size_t WordCount>
+    class Words
+    {
+    public:
+        [[nodiscard]] Raw_t load(size_t w) const
+        {
+            return words[w];
+        }
+
+        void store(size_t w, Raw_t raw)
+        {
+            words[w] = raw;
+        }
+
+        void beginWrite()
+        {
+            writeCount++;
+        }
+
+        void endWrite()
+        {
+        }
+
+        template <typename Function>
+        void readConsistent(Function &&read) const
+        {
+            read();
+        }
+
+        [[nodiscard]] uint32_t getWriteCount() const
+        {
+            return writeCount;
+        }
+
+    private:
+        std::array<Raw_t, WordCount> words{};
+        uint32_t writeCount = 0;
+    };
+};
+
+/// Values may be read from any thread without locking: each word is a relaxed atomic, which
+/// compiles to plain loads and stores on single and multi core targets. Consistent reads of
+/// several values go through a sequence lock, readers retry while a write is in progress.
+/// Changing values is meant for one thread at a time, e.g. the config thread also running
+/// SettingsIO and notifications.
+/// Consistent reads spin while a write is in progress, so don't do them from an interrupt or a
+/// task preempting the writer on a single core.
+struct SeqLockAccess
+{
+    template <class Raw_t, size_t WordCount>
+    class Words
+    {
+    public:
+        static_assert(std::atomic<Raw_t>::is_always_lock_free);
+
+        [[nodiscard]] Raw_t load(size_t w) const
+        {
+            return words[w].load(std::memory_order_relaxed);
+        }
+
+        /// Only inside beginWrite() / endWrite().
+        void store(size_t w, Raw_t raw)
+        {
+            words[w].store(raw, std::memory_order_relaxed);
+        }
+
+        void beginWrite()
+        {
+            const uint32_t Sequence = sequence.load(std::memory_order_relaxed);
+            sequence.store(Sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        void endWrite()
+        {
+            sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /// Repeats read() until no write happened while it ran.
+        template <typename Function>
+        void readConsistent(Function &&read) const
+        {
+            while (true)
+            {
+                const uint32_t Sequence = sequence.load(std::memory_order_acquire);
+                if ((Sequence & 1) != 0)
+                {
+                    continue;
+                }
+                read();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == Sequence)
+                {
+                    return;
+                }
+            }
+        }
+
+        [[nodiscard]] uint32_t getWriteCount() const
+        {
+            return sequence.load(std::memory_order_relaxed) / 2;
+        }
+
+    private:
+        std::array<std::atomic<Raw_t>, WordCount> words{};
+        /// odd while values are written
+        std::atomic<uint32_t> sequence{0};
+    };
+};
+
+/// Access policy of the SettingsContainer of entryArray, PlainAccess unless specialized before
+/// the container is used, e.g. next to the entry array:
+///     template <>
+///     struct settings::ValueAccessOf<EntryArray.size(), EntryArray>
+///     {
+///         using type = settings::SeqLockAccess;
+///     };
+template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray>
+struct ValueAccessOf
+{
+    using type = PlainAccess;
+};
+
+} // namespace settings
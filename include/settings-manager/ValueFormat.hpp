@@ -0,0 +1,236 @@
+#pragma once
+
+#include "settings-manager/ValueLayout.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace settings
+{
+
+/// Formats of the values saved to EEPROM by SettingsIO.
+/// A format provides a serializer for the values of an entry array:
+///     using Serializer = Format::Serializer<SettingsCount, entryArray>;
+///     typename Serializer::Image image;
+///     Serializer::serialize(values, image);
+///     values = Serializer::deserialize(image);
+///     Raw_t raw = Serializer::getRaw(image, index);
+///     size_t bytes = Serializer::getSerializedSize();
+/// Changing the format of a SettingsIO invalidates its existing EEPROM content.
+
+/// Value words of the SettingsContainer as they are, see ValueLayout. Fastest, native byte order.
+/// Default.
+struct NativeFormat
+{
+    template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray>
+    class Serializer
+    {
+    public:
+        using Layout = ValueLayout<SettingsCount, entryArray>;
+        using Image = typename Layout::Words;
+
+        /// The type of an entry describes its value, see CompactFormat.
+        static constexpr size_t FieldWordCount = 0;
+        using FieldWords = std::array<uint32_t, FieldWordCount>;
+
+        [[nodiscard]] static constexpr FieldWords getFieldWords(size_t /*index*/)
+        {
+            return {};
+        }
+
+        [[nodiscard]] static constexpr size_t getSerializedSize()
+        {
+            return sizeof(Image);
+        }
+
+        static void serialize(const typename Layout::Words &values, Image &image)
+        {
+            image = values;
+        }
+
+        [[nodiscard]] static typename Layout::Words deserialize(const Image &image)
+        {
+            return image;
+        }
+
+        [[nodiscard]] static typename Layout::Raw_t getRaw(const Image &image, size_t index)
+        {
+            return Layout::getRaw(image, index);
+        }
+    };
+};
+
+namespace detail
+{
+[[nodiscard]] constexpr size_t getCompactBitWidth(const SettingsEntry &entry)
+{
+    switch (entry.variableType)
+    {
+    case VariableType::booleanType:
+        return 1;
+    case VariableType::integerType:
+    {
+        auto range =
+            static_cast<uint32_t>(static_cast<int64_t>(entry.maxInteger) - entry.minInteger);
+        size_t width = 0;
+        for (; range != 0; range >>= 1)
+        {
+            width++;
+        }
+        return width;
+    }
+    default:
+        return 32;
+    }
+}
+
+template <size_t SettingsCount>
+[[nodiscard]] constexpr std::array<size_t, SettingsCount + 1>
+createCompactBitOffsets(const std::array<SettingsEntry, SettingsCount> &entries)
+{
+    std::array<size_t, SettingsCount + 1> offsets{};
+    for (size_t i = 0; i < SettingsCount; ++i)
+    {
+        offsets[i + 1] = offsets[i] + getCompactBitWidth(entries[i]);
+    }
+    return offsets;
+}
+} // namespace detail
+
+/// Bit stream of all values in index order, smaller than NativeFormat.
+/// Booleans take one bit, integers the bits needed for max - min, stored as offset to min, and
+/// reals 32 bits. Bits are filled from the least significant one of the first byte on, so
+/// multibyte values are little endian. With the little endian header of SettingsIO, images are
+/// the same on every target.
+struct CompactFormat
+{
+    template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray>
+    class Serializer
+    {
+    private:
+        /// first bit of each setting, followed by the total bit count
+        static constexpr auto BitOffsets = detail::createCompactBitOffsets(entryArray);
+        static constexpr size_t SerializedSize = (BitOffsets[SettingsCount] + 7) / 8;
+
+    public:
+        using Layout = ValueLayout<SettingsCount, entryArray>;
+        using Raw_t = typename Layout::Raw_t;
+
+        /// bits used by a setting
+        [[nodiscard]] static constexpr size_t getBitWidth(size_t index)
+        {
+            return BitOffsets[index + 1] - BitOffsets[index];
+        }
+
+        /// Describes the field of an entry, so values saved with another entry array can be read:
+        /// the raw value stored as 0, followed by the bit width.
+        static constexpr size_t FieldWordCount = 2;
+        using FieldWords = std::array<uint32_t, FieldWordCount>;
+
+        [[nodiscard]] static constexpr FieldWords getFieldWords(size_t index)
+        {
+            return {fromField(index, 0), static_cast<uint32_t>(getBitWidth(index))};
+        }
+
+        [[nodiscard]] static constexpr size_t getSerializedSize()
+        {
+            return SerializedSize;
+        }
+
+        using Image = std::array<uint8_t, SerializedSize == 0 ? 1 : SerializedSize>;
+
+        static void serialize(const typename Layout::Words &values, Image &image)
+        {
+            size_t byte = 0;
+            uint64_t pending = 0;
+            size_t pendingBits = 0;
+            for (size_t i = 0; i < SettingsCount; ++i)
+            {
+                // a value out of bounds must not spill into the following fields
+                pending |= (toField(i, Layout::getRaw(values, i)) & getFieldMask(i))
+                           << pendingBits;
+                pendingBits += getBitWidth(i);
+                for (; pendingBits >= 8; pendingBits -= 8)
+                {
+                    image[byte++] = static_cast<uint8_t>(pending);
+                    pending >>= 8;
+                }
+            }
+            if (pendingBits > 0)
+            {
+                image[byte] = static_cast<uint8_t>(pending);
+            }
+        }
+
+        /// Values read may be out of bounds, integers with a range not filling their bits.
+        [[nodiscard]] static typename Layout::Words deserialize(const Image &image)
+        {
+            typename Layout::Words values{};
+            for (size_t i = 0; i < SettingsCount; ++i)
+            {
+                Layout::setRaw(values, i, getRaw(image, i));
+            }
+            return values;
+        }
+
+        [[nodiscard]] static Raw_t getRaw(const Image &image, size_t index)
+        {
+            const size_t Offset = BitOffsets[index];
+            return fromField(index,
+                             readField(image.data() + Offset / 8, Offset % 8, getBitWidth(index)));
+        }
+
+        /// Reads a field saved with another entry array.
+        /// @param bytes the bytes of the field, starting with the one holding its first bit
+        /// @param firstBit bit of the field in bytes[0]
+        /// @param field words of the other entry, a width of at most 32 bits
+        [[nodiscard]] static Raw_t getRaw(const uint8_t *bytes, size_t firstBit,
+                                          const FieldWords &field)
+        {
+            return readField(bytes, firstBit, field[1]) + field[0];
+        }
+
+        /// bytes spanned by a field of width bits starting at firstBit of the first one
+        [[nodiscard]] static constexpr size_t getFieldBytes(size_t firstBit, size_t width)
+        {
+            return (firstBit + width + 7) / 8;
+        }
+
+    private:
+        [[nodiscard]] static constexpr uint64_t getFieldMask(size_t index)
+        {
+            return (uint64_t{1} << getBitWidth(index)) - 1;
+        }
+
+        [[nodiscard]] static Raw_t readField(const uint8_t *bytes, size_t firstBit, size_t width)
+        {
+            uint64_t field = 0;
+            for (size_t byte = getFieldBytes(firstBit, width); byte > 0; --byte)
+            {
+                field = (field << 8) | bytes[byte - 1];
+            }
+            return static_cast<Raw_t>((field >> firstBit) & ((uint64_t{1} << width) - 1));
+        }
+
+        [[nodiscard]] static constexpr Raw_t toField(size_t index, Raw_t raw)
+        {
+            if (Layout::Tables::getVariableType(index) == VariableType::integerType)
+            {
+                return raw - Layout::Tables::getMinRaw(index);
+            }
+            return raw;
+        }
+
+        [[nodiscard]] static constexpr Raw_t fromField(size_t index, Raw_t field)
+        {
+            if (Layout::Tables::getVariableType(index) == VariableType::integerType)
+            {
+                return field + Layout::Tables::getMinRaw(index);
+            }
+            return field;
+        }
+    };
+};
+
+} // namespace settings
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "settings-manager/EntryTables.hpp"
+#include "settings-manager/SettingsEntry.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+namespace settings
+{
+
+/// Native storage of all values in 32 bit words, as kept by SettingsContainer and saved to EEPROM.
+/// Real and integer settings own a word each, holding the float bits or the int32_t. Boolean
+/// settings are packed into bits of the words following them, 32 per word.
+/// A single value is handled as its raw word: float bits, int32_t bits or 0 / 1.
+/// @tparam SettingsCount
+/// @tparam entryArray
+template <size_t SettingsCount, const std::array<SettingsEntry, SettingsCount> &entryArray>
+class ValueLayout
+{
+public:
+    using Tables = EntryTables<SettingsCount, entryArray>;
+    using Raw_t = typename Tables::Raw_t;
+    static constexpr size_t BitsPerWord = 32;
+
+    [[nodiscard]] static constexpr size_t countBooleans()
+    {
+        size_t count = 0;
+        for (const auto &entry : entryArray)
+        {
+            count += entry.variableType == VariableType::booleanType ? 1 : 0;
+        }
+        return count;
+    }
+
+    static constexpr size_t BooleanCount = countBooleans();
+    static constexpr size_t WordCount =
+        SettingsCount - BooleanCount + (BooleanCount + BitsPerWord - 1) / BitsPerWord;
+    using Words = std::array<Raw_t, WordCount == 0 ? 1 : WordCount>;
+
+    /// word holding the value of a setting
+    [[nodiscard]] static constexpr size_t wordOf(size_t index)
+    {
+        return Placement.words[index];
+    }
+
+    /// Raw value of a setting from the word holding it.
+    [[nodiscard]] static constexpr Raw_t extractRaw(size_t index, Raw_t word)
+    {
+        if (Tables::getVariableType(index) == VariableType::booleanType)
+        {
+            return (word >> Placement.bits[index]) & 1;
+        }
+        return word;
+    }
+
+    /// Word holding the value of a setting with raw inserted.
+    [[nodiscard]] static constexpr Raw_t insertRaw(size_t index, Raw_t word, Raw_t raw)
+    {
+        if (Tables::getVariableType(index) == VariableType::booleanType)
+        {
+            const Raw_t Bit = Raw_t{1} << Placement.bits[index];
+            return raw != 0 ? (word | Bit) : (word & ~Bit);
+        }
+        return raw;
+    }
+
+    [[nodiscard]] static constexpr Raw_t getRaw(const Words &words, size_t index)
+    {
+        return extractRaw(index, words[wordOf(index)]);
+    }
+
+    static constexpr void setRaw(Words &words, size_t index, Raw_t raw)
+    {
+        words[wordOf(index)] = insertRaw(index, words[wordOf(index)], raw);
+    }
+
+    /// Converts a raw value of a setting of type Type.
+    template <VariableType Type, typename T>
+    [[nodiscard]] static constexpr T decodeAs(Raw_t raw)
+    {
+        if constexpr (Type == VariableType::realType)
+        {
+            return static_cast<T>(__builtin_bit_cast(SettingsValue_t, raw));
+        }
+        else if constexpr (Type == VariableType::integerType)
+        {
+            return static_cast<T>(static_cast<int32_t>(raw));
+        }
+        else
+        {
+            return static_cast<T>(raw != 0);
+        }
+    }
+
+    template <typename T>
+    [[nodiscard]] static constexpr T decode(size_t index, Raw_t raw)
+    {
+        switch (Tables::getVariableType(index))
+        {
+        case VariableType::integerType:
+            return decodeAs<VariableType::integerType, T>(raw);
+        case VariableType::booleanType:
+            return decodeAs<VariableType::booleanType, T>(raw);
+        default:
+            return decodeAs<VariableType::realType, T>(raw);
+        }
+    }
+
+    /// Converts value to the raw value of a setting, checking its bounds.
+    /// Integer settings take integers exactly and round floating point values.
+    /// Boolean settings take values from 0 to 1, everything but 0 is true.
+    /// @return bounds validity and raw value
+    template <typename T>
+    [[nodiscard]] static std::tuple<bool, Raw_t> encode(size_t index, T value)
+    {
+        const VariableType Type = Tables::getVariableType(index);
+        bool isInBounds = false;
+        if (Type == VariableType::integerType)
+        {
+            const auto Min = static_cast<int32_t>(Tables::getMinRaw(index));
+            const auto Max = static_cast<int32_t>(Tables::getMaxRaw(index));
+            if constexpr (std::is_integral_v<T>)
+            {
+                const bool IsInInt64Range = !std::is_unsigned_v<T> ||
+                                            static_cast<uint64_t>(value) <= uint64_t{INT32_MAX};
+                isInBounds = IsInInt64Range && static_cast<int64_t>(value) >= Min &&
+                             static_cast<int64_t>(value) <= Max;
+            }
+            else
+            {
+                const auto Rounded = std::round(static_cast<double>(value));
+                isInBounds = Rounded >= Min && Rounded <= Max;
+            }
+        }
+        else if (Type == VariableType::booleanType)
+        {
+            const auto Value = static_cast<double>(value);
+            isInBounds = Value >= 0 && Value <= 1;
+        }
+        else
+        {
+            const auto Value = static_cast<SettingsValue_t>(value);
+            isInBounds = !(Value > __builtin_bit_cast(SettingsValue_t, Tables::getMaxRaw(index)) ||
+                           Value < __builtin_bit_cast(SettingsValue_t, Tables::getMinRaw(index)));
+        }
+
+        if (!isInBounds)
+        {
+            return std::make_tuple(false, 0);
+        }
+        return std::make_tuple(true, toRaw(index, value));
+    }
+
+    /// Converts value to the raw value of a setting without any bounds check.
+    template <typename T>
+    [[nodiscard]] static Raw_t toRaw(size_t index, T value)
+    {
+        switch (Tables::getVariableType(index))
+        {
+        case VariableType::integerType:
+            if constexpr (std::is_integral_v<T>)
+            {
+                return static_cast<Raw_t>(static_cast<int32_t>(value));
+            }
+            else
+            {
+                return static_cast<Raw_t>(static_cast<int32_t>(std::round(value)));
+            }
+        case VariableType::booleanType:
+            return value != 0 ? 1 : 0;
+        default:
+            return __builtin_bit_cast(Raw_t, static_cast<SettingsValue_t>(value));
+        }
+    }
+
+    /// True if raw is a valid value of the setting.
+    [[nodiscard]] static constexpr bool isInBounds(size_t index, Raw_t raw)
+    {
+        switch (Tables::getVariableType(index))
+        {
+        case VariableType::integerType:
+        {
+            const auto Value = static_cast<int32_t>(raw);
+            return Value >= static_cast<int32_t>(Tables::getMinRaw(index)) &&
+                   Value <= static_cast<int32_t>(Tables::getMaxRaw(index));
+        }
+        case VariableType::booleanType:
+            return true;
+        default:
+        {
+            const auto Value = __builtin_bit_cast(SettingsValue_t, raw);
+            return !(Value > __builtin_bit_cast(SettingsValue_t, Tables::getMaxRaw(index)) ||
+                     Value < __builtin_bit_cast(SettingsValue_t, Tables::getMinRaw(index)));
+        }
+        }
+    }
+
+    [[nodiscard]] static constexpr Raw_t getDefaultRaw(size_t index)
+    {
+        return Tables::getDefaultRaw(index);
+    }
+
+private:
+    struct PlacementTable
+    {
+        std::array<size_t, SettingsCount> words{};
+        std::array<uint8_t, SettingsCount> bits{};
+    };
+
+    [[nodiscard]] static constexpr PlacementTable createPlacement()
+    {
+        PlacementTable table{};
+        size_t nextWord = 0;
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            if (entryArray[i].variableType != VariableType::booleanType)
+            {
+                table.words[i] = nextWord++;
+            }
+        }
+        size_t nextBit = 0;
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            if (entryArray[i].variableType == VariableType::booleanType)
+            {
+                table.words[i] = nextWord + nextBit / BitsPerWord;
+                table.bits[i] = static_cast<uint8_t>(nextBit % BitsPerWord);
+                nextBit++;
+            }
+        }
+        return table;
+    }
+
+    static constexpr PlacementTable Placement = createPlacement();
+
+public:
+    [[nodiscard]] static constexpr Words createDefaultWords()
+    {
+        Words words{};
+        for (size_t i = 0; i < SettingsCount; ++i)
+        {
+            setRaw(words, i, getDefaultRaw(i));
+        }
+        return words;
+    }
+};
+
+} // namespace settings
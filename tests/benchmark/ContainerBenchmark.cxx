@@ -0,0 +1,132 @@
+#include "GeneratedSettings.hpp"
+#include "TestSettings.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace settings;
+
+namespace
+{
+TestSettings::Container container;
+
+/// Thread 0 writes groups while all others read, see ->Threads().
+void readWhileWriting(benchmark::State &state)
+{
+    SettingsValue_t value = 1;
+    for (auto _ : state)
+    {
+        if (state.thread_index() == 0)
+        {
+            value = value >= 99 ? 1 : value + 1;
+            benchmark::DoNotOptimize(container.setValues<TestSettings::Entry1, TestSettings::Entry2>(
+                {value, 2 * value}));
+        }
+        else
+        {
+            benchmark::DoNotOptimize(container.getValue<TestSettings::Entry1>());
+        }
+    }
+}
+
+void readGroupWhileWriting(benchmark::State &state)
+{
+    SettingsValue_t value = 1;
+    for (auto _ : state)
+    {
+        if (state.thread_index() == 0)
+        {
+            value = value >= 99 ? 1 : value + 1;
+            benchmark::DoNotOptimize(container.setValues<TestSettings::Entry1, TestSettings::Entry2>(
+                {value, 2 * value}));
+        }
+        else
+        {
+            benchmark::DoNotOptimize(
+                container.getValues<TestSettings::Entry1, TestSettings::Entry2>());
+        }
+    }
+}
+
+void readOnly(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(container.getValue<TestSettings::Entry1>());
+        benchmark::DoNotOptimize(container.getValues<TestSettings::Entry1, TestSettings::Entry2>());
+    }
+}
+
+template <size_t Count>
+using GeneratedContainer = SettingsContainer<Count, GeneratedSettings::EntryArray<Count>>;
+
+/// Last entry of a generated table, the worst case for lookups scanning the table.
+template <size_t Count>
+constexpr const std::string_view &LastName = GeneratedSettings::Name<Count, Count - 1>;
+
+template <size_t Count>
+void getValueByTemplate(benchmark::State &state)
+{
+    static GeneratedContainer<Count> generated;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(generated.template getValue<LastName<Count>>());
+    }
+}
+
+template <size_t Count>
+void getValueByName(benchmark::State &state)
+{
+    static GeneratedContainer<Count> generated;
+    size_t index = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(generated.getValue(GeneratedSettings::Names<Count>::get(index)));
+        index = (index + 1) % Count;
+    }
+}
+
+/// Every Count + 2nd value is out of bounds and rejected.
+template <size_t Count>
+void setValueByTemplate(benchmark::State &state)
+{
+    static GeneratedContainer<Count> generated;
+    SettingsValue_t value = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(generated.template setValue<LastName<Count>>(value));
+        value = value > Count ? 0 : value + 1;
+    }
+}
+
+template <size_t Count>
+void setValueByName(benchmark::State &state)
+{
+    static GeneratedContainer<Count> generated;
+    size_t index = 0;
+    SettingsValue_t value = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            generated.setValue(GeneratedSettings::Names<Count>::get(index), value));
+        index = (index + 1) % Count;
+        value = value > Count ? 0 : value + 1;
+    }
+}
+
+BENCHMARK(readOnly)->ThreadRange(1, 4);
+BENCHMARK(readWhileWriting)->ThreadRange(2, 4)->UseRealTime();
+BENCHMARK(readGroupWhileWriting)->ThreadRange(2, 4)->UseRealTime();
+
+BENCHMARK_TEMPLATE(getValueByTemplate, 8);
+BENCHMARK_TEMPLATE(getValueByTemplate, 128);
+BENCHMARK_TEMPLATE(getValueByTemplate, 2048);
+BENCHMARK_TEMPLATE(getValueByName, 8);
+BENCHMARK_TEMPLATE(getValueByName, 128);
+BENCHMARK_TEMPLATE(getValueByName, 2048);
+BENCHMARK_TEMPLATE(setValueByTemplate, 8);
+BENCHMARK_TEMPLATE(setValueByTemplate, 128);
+BENCHMARK_TEMPLATE(setValueByTemplate, 2048);
+BENCHMARK_TEMPLATE(setValueByName, 8);
+BENCHMARK_TEMPLATE(setValueByName, 128);
+BENCHMARK_TEMPLATE(setValueByName, 2048);
+} // namespace
@@ -0,0 +1,35 @@
+#include "settings-manager/Integrity.hpp"
+#include "settings-manager/SettingsEntry.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <numeric>
+#include <vector>
+
+using namespace settings;
+
+namespace
+{
+/// Hashes a value array like SettingsIO::hashSettingsValues().
+template <class Integrity>
+void hashValues(benchmark::State &state)
+{
+    std::vector<SettingsValue_t> values(static_cast<size_t>(state.range(0)));
+    std::iota(values.begin(), values.end(), 0.5f);
+    const auto Begin = reinterpret_cast<const uint8_t *>(values.data());
+    const auto End = Begin + values.size() * sizeof(SettingsValue_t);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(
+            Integrity::finish(Integrity::update(Integrity::init(), Begin, End)));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * (End - Begin));
+}
+
+BENCHMARK_TEMPLATE(hashValues, FnvIntegrity)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(hashValues, Crc32Integrity)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(hashValues, WordIntegrity)->Arg(16)->Arg(256)->Arg(4096);
+} // namespace
+
+BENCHMARK_MAIN();
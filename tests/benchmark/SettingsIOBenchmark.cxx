@@ -0,0 +1,119 @@
+#include "GeneratedSettings.hpp"
+#include "settings-manager/SettingsContainer.hpp"
+#include "settings-manager/SettingsIO.hpp"
+
+#include <eeprom-driver/EepromBase.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstring>
+
+using namespace settings;
+
+namespace
+{
+/// Like FakeEeprom, big enough for the content of 2048 settings.
+class LargeFakeEeprom : public EepromBase<256, uint16_t>
+{
+public:
+    LargeFakeEeprom()
+    {
+        fakeMemory.fill(0xFF);
+    }
+
+    void read(uint16_t address, uint8_t *buffer, size_t length) override
+    {
+        std::memcpy(buffer, fakeMemory.data() + address, length);
+    }
+
+    void write(uint16_t address, const uint8_t *data, size_t length) override
+    {
+        std::memcpy(fakeMemory.data() + address, data, length);
+    }
+
+private:
+    std::array<uint8_t, getSizeInBytes()> fakeMemory;
+};
+
+template <size_t Count>
+struct Generated
+{
+    using Container = SettingsContainer<Count, GeneratedSettings::EntryArray<Count>>;
+    using IO = SettingsIO<Count, GeneratedSettings::EntryArray<Count>, LargeFakeEeprom>;
+    static_assert(sizeof(typename IO::EepromContent) <= LargeFakeEeprom::getSizeInBytes());
+
+    LargeFakeEeprom eeprom;
+    Container container;
+    IO io{eeprom, container};
+
+    Generated()
+    {
+        io.loadSettings();
+    }
+};
+
+template <size_t Count>
+void loadSettings(benchmark::State &state)
+{
+    static Generated<Count> generated;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(generated.io.loadSettings());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            sizeof(typename Generated<Count>::IO::EepromContent));
+}
+
+/// Compares all values and writes the page of the changed one and the header.
+template <size_t Count>
+void saveSettings(benchmark::State &state)
+{
+    static Generated<Count> generated;
+    SettingsValue_t value = 0;
+    for (auto _ : state)
+    {
+        value = value >= Count ? 0 : value + 1;
+        generated.container.setValue(size_t{0}, value);
+        generated.io.saveSettings();
+    }
+}
+
+template <size_t Count>
+void saveChangedSettings(benchmark::State &state)
+{
+    static Generated<Count> generated;
+    SettingsValue_t value = 0;
+    for (auto _ : state)
+    {
+        value = value >= Count ? 0 : value + 1;
+        generated.container.setValue(size_t{0}, value);
+        generated.io.saveChangedSettings();
+    }
+}
+
+template <size_t Count>
+void hashSettingsValues(benchmark::State &state)
+{
+    using IO = typename Generated<Count>::IO;
+    typename IO::ValueImage values{};
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(IO::hashSettingsValues(values, 1));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * sizeof(values));
+}
+
+BENCHMARK_TEMPLATE(loadSettings, 8);
+BENCHMARK_TEMPLATE(loadSettings, 128);
+BENCHMARK_TEMPLATE(loadSettings, 2048);
+BENCHMARK_TEMPLATE(saveSettings, 8);
+BENCHMARK_TEMPLATE(saveSettings, 128);
+BENCHMARK_TEMPLATE(saveSettings, 2048);
+BENCHMARK_TEMPLATE(saveChangedSettings, 8);
+BENCHMARK_TEMPLATE(saveChangedSettings, 128);
+BENCHMARK_TEMPLATE(saveChangedSettings, 2048);
+BENCHMARK_TEMPLATE(hashSettingsValues, 8);
+BENCHMARK_TEMPLATE(hashSettingsValues, 128);
+BENCHMARK_TEMPLATE(hashSettingsValues, 2048);
+} // namespace
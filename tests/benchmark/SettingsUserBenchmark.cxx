@@ -0,0 +1,54 @@
+#include "TestSettings.hpp"
+#include "settings-manager/IndexSet.hpp"
+#include "settings-manager/SettingsUser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace settings;
+
+namespace
+{
+template <class Base>
+class CountingUser : public Base
+{
+public:
+    void onSettingsUpdate() override
+    {
+        updates++;
+    }
+
+    size_t updates = 0;
+};
+
+using Subscriber = SettingsSubscriber<TestSettings::Container, TestSettings::Entry1>;
+
+/// Every registered user is notified.
+void notifyAll(benchmark::State &state)
+{
+    std::vector<CountingUser<SettingsUser>> users(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        SettingsUser::notifySettingsUpdate();
+    }
+    benchmark::DoNotOptimize(users.front().updates);
+}
+
+/// No subscriber depends on the change, the cost of filtering only.
+void notifyUnaffected(benchmark::State &state)
+{
+    std::vector<CountingUser<Subscriber>> users(static_cast<size_t>(state.range(0)));
+    IndexSet<TestSettings::EntryArray.size()> changedEntries;
+    changedEntries.set(TestSettings::Container::getIndex<TestSettings::Entry2>());
+    const SettingsChanges Changes{TestSettings::Container::getIdentity(), changedEntries};
+    for (auto _ : state)
+    {
+        SettingsUser::notifySettingsUpdate(Changes);
+    }
+    benchmark::DoNotOptimize(users.front().updates);
+}
+
+BENCHMARK(notifyAll)->Arg(8)->Arg(128)->Arg(2048);
+BENCHMARK(notifyUnaffected)->Arg(8)->Arg(128)->Arg(2048);
+} // namespace
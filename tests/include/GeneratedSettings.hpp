@@ -0,0 +1,64 @@
+#pragma once
+
+#include "settings-manager/SettingsEntry.hpp"
+
+#include <array>
+#include <string_view>
+#include <utility>
+
+/// Synthetic entry tables of arbitrary size for scaling tests.
+/// Names are "setting0000", "setting0001", ... stored in one static buffer.
+namespace GeneratedSettings
+{
+constexpr size_t NameLength = 11;
+
+template <size_t Count>
+struct Names
+{
+    static_assert(Count <= 10000, "name format supports four digits");
+
+    static constexpr std::array<char, Count * NameLength> createStorage()
+    {
+        std::array<char, Count * NameLength> storage{};
+        constexpr std::string_view Prefix = "setting";
+        for (size_t i = 0; i < Count; ++i)
+        {
+            char *name = storage.data() + i * NameLength;
+            for (size_t c = 0; c < Prefix.size(); ++c)
+            {
+                name[c] = Prefix[c];
+            }
+            name[7] = static_cast<char>('0' + (i / 1000) % 10);
+            name[8] = static_cast<char>('0' + (i / 100) % 10);
+            name[9] = static_cast<char>('0' + (i / 10) % 10);
+            name[10] = static_cast<char>('0' + i % 10);
+        }
+        return storage;
+    }
+
+    static constexpr std::array<char, Count * NameLength> Storage = createStorage();
+
+    static constexpr std::string_view get(size_t index)
+    {
+        return {Storage.data() + index * NameLength, NameLength};
+    }
+};
+
+/// Name of an entry with static storage, for the name templated accessors.
+template <size_t Count, size_t Index>
+inline constexpr std::string_view Name = Names<Count>::get(Index);
+
+template <size_t Count, size_t... Indices>
+constexpr std::array<settings::SettingsEntry, Count> createEntries(std::index_sequence<Indices...>)
+{
+    // min 0, default index, max Count
+    return {settings::SettingsEntry{0, static_cast<settings::SettingsValue_t>(Indices),
+                                    static_cast<settings::SettingsValue_t>(Count),
+                                    Names<Count>::get(Indices)}...};
+}
+
+template <size_t Count>
+inline constexpr std::array<settings::SettingsEntry, Count> EntryArray =
+    createEntries<Count>(std::make_index_sequence<Count>{});
+
+} // namespace GeneratedSettings
@@ -39,6 +39,23 @@ constexpr std::array EntryArray = {
     settings::SettingsEntry{EntryInteger_min, EntryInteger_default, EntryInteger_max, EntryInteger,
                             settings::VariableType::integerType},
 };
+} // namespace TestSettings
+
+/// counts runtime name lookups, declared before the container is used anywhere
+template <>
+struct settings::NameLookupObserver<TestSettings::EntryArray.size(), TestSettings::EntryArray>
+{
+    inline static size_t lookupCount = 0;
+
+    static void onLookup()
+    {
+        ++lookupCount;
+    }
+};
+
+namespace TestSettings
+{
+using NameLookups = settings::NameLookupObserver<EntryArray.size(), EntryArray>;
 using Container = settings::SettingsContainer<EntryArray.size(), EntryArray>;
 using IO = settings::SettingsIO<EntryArray.size(), EntryArray, FakeEeprom>;
 } // namespace TestSettings
\ No newline at end of file
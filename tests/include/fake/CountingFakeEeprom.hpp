@@ -0,0 +1,73 @@
+#pragma once
+
+#include "fake/FakeEeprom.hpp"
+
+#include <chrono>
+#include <cstddef>
+
+/// FakeEeprom counting page programs and the simulated time the EEPROM is busy with them.
+/// Every page touched by a write is one page program taking one write cycle.
+/// Simulated time only passes by advanceTime(), accesses while busy are counted.
+class CountingFakeEeprom : public FakeEeprom
+{
+public:
+    static constexpr std::chrono::microseconds WriteCycleTime{5000};
+
+    void write(AddressSize address, const uint8_t *data, size_t length) override
+    {
+        FakeEeprom::write(address, data, length);
+        accessesWhileBusy += isReady() ? 0 : 1;
+
+        const size_t FirstPage = address / getPageSize();
+        const size_t LastPage = (address + length - 1) / getPageSize();
+        writeCalls++;
+        bytesWritten += length;
+        pagePrograms += LastPage - FirstPage + 1;
+        busyTime += WriteCycleTime * (LastPage - FirstPage + 1);
+        busyUntil = now + WriteCycleTime * (LastPage - FirstPage + 1);
+        lastWriteAddress = address;
+        lastWriteLength = length;
+    }
+
+    void read(AddressSize address, uint8_t *buffer, size_t length) override
+    {
+        FakeEeprom::read(address, buffer, length);
+        accessesWhileBusy += isReady() ? 0 : 1;
+        readCalls++;
+        bytesRead += length;
+    }
+
+    /// Doesn't acknowledge accesses until the last write cycle is finished.
+    [[nodiscard]] bool isReady() const
+    {
+        return now >= busyUntil;
+    }
+
+    void advanceTime(std::chrono::microseconds duration)
+    {
+        now += duration;
+    }
+
+    void resetCounters()
+    {
+        accessesWhileBusy = 0;
+        writeCalls = 0;
+        readCalls = 0;
+        bytesWritten = 0;
+        bytesRead = 0;
+        pagePrograms = 0;
+        busyTime = std::chrono::microseconds{0};
+    }
+
+    size_t writeCalls = 0;
+    size_t readCalls = 0;
+    size_t bytesWritten = 0;
+    size_t bytesRead = 0;
+    size_t pagePrograms = 0;
+    size_t accessesWhileBusy = 0;
+    std::chrono::microseconds busyTime{0};
+    std::chrono::microseconds now{0};
+    std::chrono::microseconds busyUntil{0};
+    AddressSize lastWriteAddress = 0;
+    size_t lastWriteLength = 0;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <chrono>
+
+/// Clock with simulated time for policies and components taking a Clock like
+/// std::chrono::steady_clock. Time only passes by advancing current.
+struct FakeClock
+{
+    using duration = std::chrono::microseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<FakeClock>;
+    static constexpr bool is_steady = true;
+
+    inline static time_point current{};
+
+    static time_point now()
+    {
+        return current;
+    }
+};
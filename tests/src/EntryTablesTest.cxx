@@ -0,0 +1,85 @@
+#include "GeneratedSettings.hpp"
+#include "TestSettings.hpp"
+#include "settings-manager/EntryTables.hpp"
+
+#include <gtest/gtest.h>
+
+#include <type_traits>
+
+using namespace settings;
+
+namespace
+{
+constexpr size_t GeneratedCount = 2048;
+using GeneratedTables = EntryTables<GeneratedCount, GeneratedSettings::EntryArray<GeneratedCount>>;
+using TestTables = EntryTables<TestSettings::EntryArray.size(), TestSettings::EntryArray>;
+
+/// integer entries with float bounds beyond the int32_t range
+constexpr std::string_view Wide = "wide";
+constexpr std::string_view Flag = "flag";
+constexpr std::array WideEntryArray = {
+    SettingsEntry{-3e9f, 7.0f, 3e9f, Wide, VariableType::integerType},
+    SettingsEntry{false, Flag},
+};
+using WideTables = EntryTables<WideEntryArray.size(), WideEntryArray>;
+
+template <class Tables, size_t SettingsCount>
+void expectSameContent(const std::array<SettingsEntry, SettingsCount> &entries)
+{
+    for (size_t i = 0; i < SettingsCount; ++i)
+    {
+        EXPECT_EQ(Tables::getName(i), entries[i].name);
+        EXPECT_TRUE(Tables::hasSameName(i, entries[i].name));
+        EXPECT_EQ(Tables::getNameHash(i), entries[i].NameHash);
+        EXPECT_EQ(Tables::getVariableType(i), entries[i].variableType);
+        if (entries[i].variableType == VariableType::realType)
+        {
+            EXPECT_EQ(Tables::toValue(i, Tables::getMinRaw(i)), entries[i].minValue);
+            EXPECT_EQ(Tables::toValue(i, Tables::getDefaultRaw(i)), entries[i].defaultValue);
+            EXPECT_EQ(Tables::toValue(i, Tables::getMaxRaw(i)), entries[i].maxValue);
+        }
+        else
+        {
+            EXPECT_EQ(static_cast<int32_t>(Tables::getMinRaw(i)), entries[i].minInteger);
+            EXPECT_EQ(static_cast<int32_t>(Tables::getDefaultRaw(i)), entries[i].defaultInteger);
+            EXPECT_EQ(static_cast<int32_t>(Tables::getMaxRaw(i)), entries[i].maxInteger);
+        }
+    }
+}
+
+TEST(EntryTablesTest, sameContentAsEntries)
+{
+    expectSameContent<TestTables>(TestSettings::EntryArray);
+    expectSameContent<GeneratedTables>(GeneratedSettings::EntryArray<GeneratedCount>);
+    expectSameContent<WideTables>(WideEntryArray);
+}
+
+TEST(EntryTablesTest, namePool)
+{
+    static_assert(GeneratedTables::NamePoolSize == GeneratedCount * GeneratedSettings::NameLength);
+    static_assert(std::is_same_v<GeneratedTables::NameOffset_t, uint16_t>);
+    static_assert(TestTables::getName(0) == TestSettings::Entry1);
+    static_assert(!TestTables::hasSameName(0, TestSettings::Entry2));
+
+    // names are adjacent in the pool, without terminators
+    EXPECT_EQ(TestTables::getName(0).data() + TestSettings::Entry1.size(),
+              TestTables::getName(1).data());
+}
+
+TEST(EntryTablesTest, saturatedIntegerBounds)
+{
+    EXPECT_EQ(WideTables::toValue(0, WideTables::getMinRaw(0)), static_cast<float>(INT32_MIN));
+    EXPECT_EQ(WideTables::toValue(0, WideTables::getMaxRaw(0)), static_cast<float>(INT32_MAX));
+    EXPECT_EQ(WideTables::toValue(0, WideTables::getDefaultRaw(0)), 7);
+    EXPECT_EQ(WideTables::getMinRaw(1), 0);
+    EXPECT_EQ(WideTables::getDefaultRaw(1), 0);
+    EXPECT_EQ(WideTables::getMaxRaw(1), 1);
+}
+
+TEST(EntryTablesTest, smallerThanEntries)
+{
+    constexpr size_t BytesPerEntry = 3 * sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint8_t) +
+                                     sizeof(GeneratedTables::NameOffset_t);
+    static_assert(BytesPerEntry < sizeof(SettingsEntry) / 2);
+}
+} // namespace
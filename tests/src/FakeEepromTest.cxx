@@ -1,3 +1,4 @@
+#include "fake/CountingFakeEeprom.hpp"
 #include "fake/FakeEeprom.hpp"
 #include <exception>
 #include <gtest/gtest.h>
@@ -74,4 +75,35 @@ TEST_F(FakeEepromTest, rangeBounds)
     ASSERT_EQ(tempMemory, tempMemory2);
 };
 
-} // namespace
\ No newline at end of file
+TEST(CountingFakeEepromTest, countsPagePrograms)
+{
+    CountingFakeEeprom eeprom;
+    constexpr auto PageSize = FakeEeprom::getPageSize();
+    std::array<uint8_t, 3 * PageSize> data{};
+
+    // within one page
+    eeprom.write(0, data.data(), PageSize);
+    EXPECT_EQ(eeprom.pagePrograms, 1);
+
+    // crossing one page boundary
+    eeprom.write(PageSize - 1, data.data(), 2);
+    EXPECT_EQ(eeprom.pagePrograms, 3);
+
+    // unaligned, spanning three pages
+    eeprom.write(PageSize / 2, data.data(), 2 * PageSize);
+    EXPECT_EQ(eeprom.pagePrograms, 6);
+
+    EXPECT_EQ(eeprom.writeCalls, 3);
+    EXPECT_EQ(eeprom.bytesWritten, 3 * PageSize + 2);
+    EXPECT_EQ(eeprom.busyTime, 6 * CountingFakeEeprom::WriteCycleTime);
+
+    eeprom.read(0, data.data(), data.size());
+    EXPECT_EQ(eeprom.readCalls, 1);
+    EXPECT_EQ(eeprom.bytesRead, data.size());
+
+    eeprom.resetCounters();
+    EXPECT_EQ(eeprom.pagePrograms, 0);
+    EXPECT_EQ(eeprom.busyTime.count(), 0);
+}
+
+} // namespace
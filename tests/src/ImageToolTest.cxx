@@ -0,0 +1,199 @@
+#include "TestSettings.hpp"
+#include "settings-manager/ImageMemory.hpp"
+#include "settings-manager/ImageTool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+
+using namespace settings;
+using namespace TestSettings;
+
+namespace
+{
+using Memory = ImageMemory<FakeEeprom::getSizeInBytes(), FakeEeprom::getPageSize()>;
+using ImageIO = SettingsIO<EntryArray.size(), EntryArray, Memory>;
+using Tool = ImageTool<ImageIO>;
+
+class ImageToolTest : public ::testing::Test
+{
+protected:
+    std::unique_ptr<Tool> tool = std::make_unique<Tool>();
+
+    /// image saved by the firmware
+    std::string createDump(float entry1)
+    {
+        FakeEeprom eeprom;
+        Container container;
+        IO io{eeprom, container};
+        io.loadSettings();
+        EXPECT_TRUE(container.setValue<Entry1>(entry1));
+        io.saveSettings();
+
+        std::string dump(FakeEeprom::getSizeInBytes(), '\0');
+        eeprom.read(0, reinterpret_cast<uint8_t *>(dump.data()), dump.size());
+        return dump;
+    }
+
+    /// image with entry1 saved as it is, bypassing the bounds checks of the firmware
+    std::string createRawDump(float entry1)
+    {
+        std::string dump = createDump(Entry1_default);
+        IO::EepromContent content;
+        std::memcpy(&content, dump.data() + IO::MemoryOffset, sizeof(content));
+        Container::Layout::setRaw(content.settingsValues, Container::getIndex<Entry1>(),
+                                  __builtin_bit_cast(Container::Raw_t, entry1));
+        content.settingsValuesHash =
+            IO::hashSettingsValues(content.settingsValues, content.generation);
+        std::memcpy(dump.data() + IO::MemoryOffset, &content, sizeof(content));
+        return dump;
+    }
+
+    static std::string writeFile(const std::string &name, const std::string &content)
+    {
+        const std::string Path = ::testing::TempDir() + name;
+        std::ofstream{Path, std::ios::binary} << content;
+        return Path;
+    }
+
+    static std::string readFile(const std::string &path)
+    {
+        std::ifstream file{path, std::ios::binary};
+        return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+    bool exportImage(const std::string &dump, std::string &text, bool asJson = false)
+    {
+        return tool->exportImage(reinterpret_cast<const uint8_t *>(dump.data()), dump.size(),
+                                 asJson, text);
+    }
+};
+
+TEST_F(ImageToolTest, imageMemory)
+{
+    Memory memory;
+    EXPECT_EQ(memory.getBytes()[0], 0xFF);
+    const uint8_t Dump[] = {1, 2, 3};
+    EXPECT_TRUE(memory.assign(Dump, sizeof(Dump)));
+    uint8_t read[4];
+    memory.read(0, read, sizeof(read));
+    EXPECT_EQ(read[2], 3);
+    EXPECT_EQ(read[3], 0xFF);
+    EXPECT_THROW(memory.read(Memory::getSizeInBytes() - 1, read, 2), std::runtime_error);
+
+    const std::string TooBig(Memory::getSizeInBytes() + 1, '\0');
+    EXPECT_FALSE(memory.assign(reinterpret_cast<const uint8_t *>(TooBig.data()), TooBig.size()));
+    EXPECT_EQ(memory.getBytes()[0], 1);
+}
+
+TEST_F(ImageToolTest, exportImage)
+{
+    std::string text;
+    EXPECT_TRUE(exportImage(createDump(55), text));
+    EXPECT_EQ(text.substr(0, 10), "entry1=55\n");
+
+    // reused for the next image
+    text.clear();
+    EXPECT_TRUE(exportImage(createDump(66), text, true));
+    EXPECT_EQ(text.substr(0, 16), "{\n  \"entry1\": 66");
+
+    std::string erased(FakeEeprom::getSizeInBytes(), '\xFF');
+    text.clear();
+    EXPECT_FALSE(exportImage(erased, text));
+    EXPECT_TRUE(text.empty());
+}
+
+TEST_F(ImageToolTest, exportAsSaved)
+{
+    // out of bounds, a load would reset it to its default
+    static_assert(Entry1_max < 1000);
+    const std::string Dump = createRawDump(1000);
+    std::string text;
+    EXPECT_TRUE(exportImage(Dump, text));
+    EXPECT_EQ(text.substr(0, 12), "entry1=1000\n");
+    EXPECT_EQ(std::memcmp(tool->getMemory().getBytes().data(), Dump.data(), Dump.size()), 0)
+        << "nothing written back";
+
+    // no JSON number
+    text.clear();
+    EXPECT_TRUE(exportImage(createRawDump(std::numeric_limits<float>::infinity()), text, true));
+    EXPECT_EQ(text.substr(0, 20), "{\n  \"entry1\": \"inf\",");
+}
+
+TEST_F(ImageToolTest, importText)
+{
+    EXPECT_TRUE(tool->importText("entry2=22\nentryBoolean=false\n").isValid());
+
+    // loads on the firmware
+    FakeEeprom eeprom;
+    eeprom.write(0, tool->getMemory().getBytes().data(), tool->getMemory().getBytes().size());
+    Container container;
+    IO io{eeprom, container};
+    EXPECT_TRUE(io.loadSettings());
+    EXPECT_EQ(container.getValue<Entry2>(), 22);
+    EXPECT_FALSE((container.getValue<EntryBoolean, bool>()));
+    EXPECT_EQ(container.getValue<Entry1>(), Entry1_default);
+
+    // every import starts from defaults
+    EXPECT_FALSE(tool->importText("entry1=1000").isValid());
+    std::string text;
+    const auto &Bytes = tool->getMemory().getBytes();
+    EXPECT_TRUE(exportImage(std::string(Bytes.begin(), Bytes.end()), text));
+    EXPECT_EQ(text.substr(0, 22), "entry1=10\nentry2=20\nen");
+}
+
+TEST_F(ImageToolTest, commandLine)
+{
+    const std::string Config = writeFile("config.txt", "entry3=33\n");
+    const std::string Image = ::testing::TempDir() + "image.bin";
+    const std::string Broken = writeFile("broken.txt", "entry3=3333\n");
+    const char *const Import[] = {"tool", "import", Config.c_str(), Image.c_str()};
+    const char *const ImportBroken[] = {"tool", "import", Broken.c_str(), Image.c_str()};
+    const char *const Export[] = {"tool", "export", "--json", Image.c_str(), Image.c_str()};
+    const char *const ExportMissing[] = {"tool", "export", "/nonexistent/image.bin"};
+    const char *const Usage[] = {"tool", "flash"};
+
+    EXPECT_EQ(tool->run(4, Import), 0);
+    EXPECT_EQ(readFile(Image).size(), Memory::getSizeInBytes());
+    EXPECT_EQ(Tool{}.run(5, Export), 0);
+    EXPECT_EQ(tool->run(4, ImportBroken), 1);
+    EXPECT_EQ(tool->run(3, ExportMissing), 1);
+    EXPECT_EQ(tool->run(2, Usage), 2);
+
+    std::string text;
+    EXPECT_TRUE(exportImage(readFile(Image), text));
+    EXPECT_NE(text.find("entry3=33\n"), std::string::npos);
+    std::remove(Config.c_str());
+    std::remove(Broken.c_str());
+    std::remove(Image.c_str());
+}
+
+TEST_F(ImageToolTest, batchKeysEscaped)
+{
+    // paths are the keys of a batch, control characters included
+    const std::string Image = writeFile("tab\tnew\nline.bin", createDump(55));
+    const char *const Export[] = {"tool", "export", "--json", Image.c_str(), Image.c_str()};
+    ::testing::internal::CaptureStdout();
+    EXPECT_EQ(tool->run(5, Export), 0);
+    const std::string Json = ::testing::internal::GetCapturedStdout();
+    EXPECT_NE(Json.find("tab\\tnew\\nline.bin\": {"), std::string::npos) << Json;
+    EXPECT_EQ(Json.find('\t'), std::string::npos);
+    std::remove(Image.c_str());
+}
+
+TEST_F(ImageToolTest, unreadableFile)
+{
+    // opens, but fails to read
+    const std::string Directory = ::testing::TempDir();
+    const std::string Image = ::testing::TempDir() + "unread.bin";
+    const char *const Import[] = {"tool", "import", Directory.c_str(), Image.c_str()};
+    EXPECT_EQ(tool->run(4, Import), 1);
+    EXPECT_FALSE(std::ifstream{Image}.good()) << "image not written";
+}
+} // namespace
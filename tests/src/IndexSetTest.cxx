@@ -0,0 +1,70 @@
+#include "settings-manager/IndexSet.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace settings;
+
+namespace
+{
+TEST(IndexSetTest, setResetTest)
+{
+    IndexSet<70> set;
+    EXPECT_FALSE(set.any());
+    EXPECT_EQ(set.count(), 0);
+
+    set.set(0);
+    set.set(33);
+    set.set(69);
+    EXPECT_TRUE(set.any());
+    EXPECT_EQ(set.count(), 3);
+    EXPECT_TRUE(set.test(33));
+    EXPECT_FALSE(set.test(32));
+
+    set.reset(33);
+    EXPECT_FALSE(set.test(33));
+    EXPECT_EQ(set.count(), 2);
+
+    set.clear();
+    EXPECT_FALSE(set.any());
+
+    EXPECT_THROW(set.set(70), std::runtime_error);
+}
+
+TEST(IndexSetTest, forEachAscending)
+{
+    IndexSet<100> set;
+    const std::vector<size_t> Expected{1, 31, 32, 63, 64, 99};
+    for (const auto Index : Expected)
+    {
+        set.set(Index);
+    }
+
+    std::vector<size_t> visited;
+    set.forEach([&](size_t index) { visited.push_back(index); });
+    EXPECT_EQ(visited, Expected);
+}
+
+TEST(IndexSetTest, findFirst)
+{
+    IndexSet<100> set;
+    EXPECT_EQ(set.findFirst(), 100);
+    set.set(77);
+    EXPECT_EQ(set.findFirst(), 77);
+    set.set(40);
+    EXPECT_EQ(set.findFirst(), 40);
+}
+
+TEST(IndexSetTest, equality)
+{
+    IndexSet<40> a;
+    IndexSet<40> b;
+    a.set(1);
+    b.set(39);
+    EXPECT_NE(a, b);
+
+    a.set(39);
+    b.set(1);
+    EXPECT_EQ(a, b);
+}
+} // namespace
@@ -0,0 +1,135 @@
+#include "TestSettings.hpp"
+#include "settings-manager/Integrity.hpp"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <string_view>
+#include <vector>
+
+using namespace settings;
+
+namespace
+{
+template <class Integrity>
+uint64_t hashOf(std::string_view text)
+{
+    const auto Begin = reinterpret_cast<const uint8_t *>(text.data());
+    return Integrity::finish(Integrity::update(Integrity::init(), Begin, Begin + text.size()));
+}
+
+/// bit by bit reference
+uint32_t referenceCrc32(const uint8_t *begin, const uint8_t *end)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (; begin != end; ++begin)
+    {
+        crc ^= *begin;
+        for (size_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1) != 0 ? (crc >> 1) ^ Crc32Integrity::Polynomial : crc >> 1;
+        }
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+template <class Integrity>
+class IntegrityTest : public ::testing::Test
+{
+};
+
+using Policies = ::testing::Types<FnvIntegrity, Crc16Integrity, Crc32Integrity, WordIntegrity>;
+TYPED_TEST_SUITE(IntegrityTest, Policies);
+
+TYPED_TEST(IntegrityTest, incrementalAtWordBorders)
+{
+    std::vector<uint8_t> bytes(100);
+    std::iota(bytes.begin(), bytes.end(), 0);
+
+    const auto Whole = TypeParam::finish(
+        TypeParam::update(TypeParam::init(), bytes.data(), bytes.data() + bytes.size()));
+    for (size_t split = 0; split <= bytes.size(); split += 4)
+    {
+        auto state = TypeParam::update(TypeParam::init(), bytes.data(), bytes.data() + split);
+        state = TypeParam::update(state, bytes.data() + split, bytes.data() + bytes.size());
+        EXPECT_EQ(TypeParam::finish(state), Whole) << split;
+    }
+}
+
+TYPED_TEST(IntegrityTest, detectsSingleBitFlips)
+{
+    std::vector<uint8_t> bytes(64, 0x5A);
+    const auto Original = TypeParam::finish(
+        TypeParam::update(TypeParam::init(), bytes.data(), bytes.data() + bytes.size()));
+    for (size_t bit = 0; bit < bytes.size() * 8; ++bit)
+    {
+        bytes[bit / 8] ^= 1 << (bit % 8);
+        EXPECT_NE(TypeParam::finish(TypeParam::update(TypeParam::init(), bytes.data(),
+                                                      bytes.data() + bytes.size())),
+                  Original)
+            << bit;
+        bytes[bit / 8] ^= 1 << (bit % 8);
+    }
+}
+
+TEST(IntegrityPolicies, fnvIsCompatible)
+{
+    constexpr std::string_view Text = "123456789";
+    EXPECT_EQ(hashOf<FnvIntegrity>(Text), core::hash::fnvStringview(Text));
+}
+
+TEST(IntegrityPolicies, crc16)
+{
+    // CRC-16/CCITT-FALSE check value
+    EXPECT_EQ(hashOf<Crc16Integrity>("123456789"), 0x29B1);
+    EXPECT_EQ(hashOf<Crc16Integrity>(""), 0xFFFF);
+}
+
+TEST(IntegrityPolicies, crc32)
+{
+    EXPECT_EQ(hashOf<Crc32Integrity>("123456789"), 0xCBF43926);
+    EXPECT_EQ(hashOf<Crc32Integrity>(""), 0);
+
+    // slicing-by-8 and its tail against the reference, all lengths and alignments
+    std::vector<uint8_t> bytes(40);
+    std::iota(bytes.begin(), bytes.end(), 0x70);
+    for (size_t begin = 0; begin < 8; ++begin)
+    {
+        for (size_t end = begin; end <= bytes.size(); ++end)
+        {
+            EXPECT_EQ(Crc32Integrity::finish(Crc32Integrity::update(
+                          Crc32Integrity::init(), bytes.data() + begin, bytes.data() + end)),
+                      referenceCrc32(bytes.data() + begin, bytes.data() + end));
+        }
+    }
+}
+
+TEST(IntegrityPolicies, murmur3)
+{
+    EXPECT_EQ(hashOf<WordIntegrity>(""), 0);
+    EXPECT_EQ(hashOf<WordIntegrity>("hello"), 0x248BFA47);
+    EXPECT_EQ(hashOf<WordIntegrity>("The quick brown fox jumps over the lazy dog"), 0x2E4FF723);
+}
+
+TEST(IntegrityPolicies, settingsIO)
+{
+    using Crc32IO = SettingsIO<TestSettings::EntryArray.size(), TestSettings::EntryArray,
+                               FakeEeprom, 1, Crc32Integrity>;
+    FakeEeprom eeprom;
+    TestSettings::Container container;
+    ASSERT_TRUE(container.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+
+    // content of another policy is invalid
+    TestSettings::IO fnvIo{eeprom, container};
+    fnvIo.saveSettings();
+    TestSettings::Container loaded;
+    Crc32IO crcIo{eeprom, loaded};
+    EXPECT_FALSE(crcIo.loadSettings());
+    EXPECT_EQ(loaded, TestSettings::Container{});
+
+    Crc32IO otherCrcIo{eeprom, container};
+    otherCrcIo.saveSettings();
+    EXPECT_TRUE(crcIo.loadSettings());
+    EXPECT_EQ(loaded, container);
+}
+} // namespace
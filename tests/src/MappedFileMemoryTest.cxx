@@ -0,0 +1,174 @@
+#include "TestSettings.hpp"
+#include "settings-manager/MappedFileMemory.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace settings;
+using namespace TestSettings;
+
+namespace
+{
+using Memory = MappedFileMemory<4 * 4096>;
+using MappedIO = SettingsIO<EntryArray.size(), EntryArray, Memory, 2>;
+static_assert(MappedIO::getSlotOffset(1) % 4096 == 0, "slots never share a system page");
+
+/// counts the copies SettingsIO makes by read()
+class CountingMemory : public Memory
+{
+public:
+    using Memory::Memory;
+
+    void read(size_t address, uint8_t *buffer, size_t length)
+    {
+        Memory::read(address, buffer, length);
+        bytesRead += length;
+    }
+
+    size_t bytesRead = 0;
+};
+
+class MappedFileMemoryTest : public ::testing::Test
+{
+protected:
+    const std::string Path = ::testing::TempDir() + "MappedFileMemoryTest.bin";
+
+    MappedFileMemoryTest()
+    {
+        std::remove(Path.c_str());
+    }
+
+    ~MappedFileMemoryTest() override
+    {
+        std::remove(Path.c_str());
+    }
+
+    [[nodiscard]] std::string readFile() const
+    {
+        std::ifstream file{Path, std::ios::binary};
+        return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+};
+
+TEST_F(MappedFileMemoryTest, createsErasedFile)
+{
+    Memory memory{Path.c_str()};
+    ASSERT_TRUE(memory.isOpen());
+    EXPECT_EQ(memory.getDirtySize(), 0);
+    EXPECT_EQ(readFile(), std::string(Memory::getSizeInBytes(), '\xFF'));
+    EXPECT_EQ(memory.data()[Memory::getSizeInBytes() - 1], 0xFF);
+}
+
+TEST_F(MappedFileMemoryTest, readWrite)
+{
+    const std::array<uint8_t, 3> Data{1, 2, 3};
+    {
+        Memory memory{Path.c_str()};
+        memory.write(100, Data.data(), Data.size());
+        EXPECT_EQ(memory.getDirtySize(), 0) << "synced by the write";
+        EXPECT_EQ(readFile().substr(100, 3), "\x01\x02\x03");
+
+        // zero copy
+        EXPECT_EQ(memory.data()[101], 2);
+        std::array<uint8_t, 4> read{};
+        memory.read(99, read.data(), read.size());
+        EXPECT_EQ(read, (std::array<uint8_t, 4>{0xFF, 1, 2, 3}));
+
+        EXPECT_TRUE(memory.flush());
+
+        EXPECT_THROW(memory.write(Memory::getSizeInBytes() - 1, Data.data(), Data.size()),
+                     std::runtime_error);
+    }
+
+    Memory reopened{Path.c_str()};
+    EXPECT_EQ(reopened.data()[102], 3);
+}
+
+TEST_F(MappedFileMemoryTest, extendsShortFile)
+{
+    std::ofstream{Path, std::ios::binary} << "abc";
+    Memory memory{Path.c_str()};
+    ASSERT_TRUE(memory.isOpen());
+    EXPECT_EQ(memory.data()[0], 'a');
+    EXPECT_EQ(memory.data()[3], 0xFF);
+    EXPECT_EQ(readFile().size(), Memory::getSizeInBytes());
+}
+
+TEST_F(MappedFileMemoryTest, failsToOpen)
+{
+    Memory memory{"/nonexistent/settings.bin"};
+    EXPECT_FALSE(memory.isOpen());
+    EXPECT_EQ(memory.data(), nullptr);
+    EXPECT_TRUE(memory.flush());
+    uint8_t byte;
+    EXPECT_THROW(memory.read(0, &byte, 1), std::runtime_error);
+
+    // slots could share a system page
+    MappedFileMemory<4096, 16> smallPages{Path.c_str()};
+    EXPECT_FALSE(smallPages.isOpen());
+}
+
+TEST_F(MappedFileMemoryTest, settingsSurviveRestart)
+{
+    {
+        Memory memory{Path.c_str()};
+        Container container;
+        MappedIO io{memory, container};
+        EXPECT_FALSE(io.loadSettings());
+        ASSERT_TRUE(container.setValue<Entry1>(Entry1_max));
+        io.saveChangedSettings();
+    }
+
+    Memory memory{Path.c_str()};
+    Container container;
+    MappedIO io{memory, container};
+    EXPECT_TRUE(io.loadSettings());
+    EXPECT_EQ(container.getValue<Entry1>(), Entry1_max);
+}
+
+TEST_F(MappedFileMemoryTest, tablesReadInPlace)
+{
+    static_assert(HasData<Memory>::value);
+    using CountingIO = SettingsIO<EntryArray.size(), EntryArray, CountingMemory, 2>;
+    CountingMemory memory{Path.c_str()};
+    Container container;
+    CountingIO io{memory, container};
+    EXPECT_FALSE(io.loadSettings());
+    io.saveSettings();
+
+    memory.bytesRead = 0;
+    EXPECT_TRUE(io.loadSettings());
+    EXPECT_EQ(memory.bytesRead, 2 * sizeof(CountingIO::ContentHead)) << "headers and values only";
+}
+
+TEST_F(MappedFileMemoryTest, tornSaveKeepsPreviousSettings)
+{
+    Memory memory{Path.c_str()};
+    {
+        Container container;
+        MappedIO io{memory, container};
+        io.loadSettings();
+        ASSERT_TRUE(container.setValue<Entry1>(Entry1_max));
+        io.saveSettings();
+
+        // power loss during the save into slot 0, only part of its page made it to the file
+        ASSERT_TRUE(container.setValue<Entry1>(Entry1_min));
+        ASSERT_TRUE(container.setValue<Entry3>(Entry3_min));
+        io.saveSettings();
+        std::array<uint8_t, 16> erased;
+        erased.fill(0xFF);
+        memory.write(MappedIO::getSlotOffset(0) + MappedIO::HeaderSize, erased.data(),
+                     erased.size());
+    }
+
+    Container container;
+    MappedIO io{memory, container};
+    EXPECT_TRUE(io.loadSettings());
+    EXPECT_EQ(container.getValue<Entry1>(), Entry1_max);
+    EXPECT_EQ(container.getValue<Entry3>(), Entry3_default);
+}
+} // namespace
@@ -0,0 +1,63 @@
+#include "GeneratedSettings.hpp"
+#include "TestSettings.hpp"
+#include "settings-manager/NameIndex.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace settings;
+
+namespace
+{
+constexpr size_t GeneratedCount = 256;
+using GeneratedIndex = NameIndex<GeneratedCount, GeneratedSettings::EntryArray<GeneratedCount>>;
+using TestIndex = NameIndex<TestSettings::EntryArray.size(), TestSettings::EntryArray>;
+
+TEST(NameIndexTest, findsEveryEntry)
+{
+    static_assert(TestIndex::isConsistent());
+    static_assert(GeneratedIndex::isConsistent());
+
+    for (size_t i = 0; i < TestSettings::EntryArray.size(); ++i)
+    {
+        const auto [exists, index] = TestIndex::find(TestSettings::EntryArray[i].name);
+        EXPECT_TRUE(exists);
+        EXPECT_EQ(index, i);
+    }
+
+    for (size_t i = 0; i < GeneratedCount; ++i)
+    {
+        const auto [exists, index] =
+            GeneratedIndex::find(GeneratedSettings::Names<GeneratedCount>::get(i));
+        EXPECT_TRUE(exists);
+        EXPECT_EQ(index, i);
+    }
+}
+
+TEST(NameIndexTest, rejectsUnknownNames)
+{
+    for (const std::string_view name : {"", "entry", "entry11", "[[[unknownName]]]", "setting0256",
+                                        "setting", "Entry1"})
+    {
+        EXPECT_FALSE(std::get<0>(TestIndex::find(name))) << name;
+        EXPECT_FALSE(std::get<0>(GeneratedIndex::find(name))) << name;
+    }
+}
+
+TEST(NameIndexTest, findHash)
+{
+    for (size_t i = 0; i < TestSettings::EntryArray.size(); ++i)
+    {
+        const auto [exists, index] = TestIndex::findHash(TestSettings::EntryArray[i].NameHash);
+        EXPECT_TRUE(exists);
+        EXPECT_EQ(index, i);
+    }
+    EXPECT_FALSE(std::get<0>(TestIndex::findHash(core::hash::fnvStringview("unknown"))));
+}
+
+TEST(NameIndexTest, compileTimeLookup)
+{
+    static_assert(std::get<1>(TestIndex::find(TestSettings::Entry3)) ==
+                  TestSettings::Container::getIndex<TestSettings::Entry3>());
+    static_assert(!std::get<0>(TestIndex::find("unknown")));
+}
+} // namespace
@@ -0,0 +1,106 @@
+#include "fake/CountingFakeEeprom.hpp"
+#include "settings-manager/PageWriter.hpp"
+
+#include <array>
+#include <gtest/gtest.h>
+#include <numeric>
+
+using namespace settings;
+
+namespace
+{
+constexpr size_t PageSize = FakeEeprom::getPageSize();
+constexpr size_t ImageSize = 3 * PageSize;
+// image starts in the middle of a page and spans four pages
+constexpr size_t BaseAddress = PageSize + PageSize / 2;
+using Writer = PageWriter<CountingFakeEeprom, ImageSize>;
+
+class PageWriterTest : public ::testing::Test
+{
+protected:
+    PageWriterTest()
+    {
+        std::iota(image.begin(), image.end(), 0);
+    }
+
+    CountingFakeEeprom eeprom{};
+    Writer writer{eeprom, BaseAddress};
+    std::array<uint8_t, ImageSize> image{};
+
+    std::array<uint8_t, ImageSize> readImage()
+    {
+        std::array<uint8_t, ImageSize> result{};
+        eeprom.read(BaseAddress, result.data(), ImageSize);
+        return result;
+    }
+};
+
+TEST_F(PageWriterTest, nothingPending)
+{
+    EXPECT_FALSE(writer.hasPendingPages());
+    EXPECT_EQ(writer.writeNextPage(image.data()), 0);
+    EXPECT_EQ(eeprom.writeCalls, 0);
+}
+
+TEST_F(PageWriterTest, writeAll)
+{
+    writer.markAll();
+    EXPECT_EQ(writer.getPendingPageCount(), 4);
+    writer.writePendingPages(image.data());
+
+    EXPECT_EQ(readImage(), image);
+    EXPECT_EQ(eeprom.writeCalls, 4);
+    EXPECT_EQ(eeprom.pagePrograms, 4);
+    EXPECT_EQ(eeprom.bytesWritten, ImageSize);
+    EXPECT_FALSE(writer.hasPendingPages());
+}
+
+TEST_F(PageWriterTest, coalescesRegionsOfOnePage)
+{
+    // three regions within the second page of the image
+    writer.markChanged(PageSize / 2, 1);
+    writer.markChanged(PageSize / 2 + 4, 4);
+    writer.markChanged(PageSize + PageSize / 2 - 1, 1);
+    EXPECT_EQ(writer.getPendingPageCount(), 1);
+
+    writer.writePendingPages(image.data());
+    EXPECT_EQ(eeprom.writeCalls, 1);
+    EXPECT_EQ(eeprom.pagePrograms, 1);
+    EXPECT_EQ(eeprom.lastWriteAddress, 2 * PageSize);
+    EXPECT_EQ(eeprom.lastWriteLength, PageSize);
+}
+
+TEST_F(PageWriterTest, regionAcrossPages)
+{
+    writer.markChanged(PageSize / 2 - 1, 2);
+    EXPECT_EQ(writer.getPendingPageCount(), 2);
+    EXPECT_EQ(writer.writeNextPage(image.data()), PageSize / 2);
+    EXPECT_EQ(eeprom.lastWriteAddress, BaseAddress);
+    EXPECT_EQ(eeprom.lastWriteLength, PageSize / 2);
+    EXPECT_EQ(writer.writeNextPage(image.data()), PageSize);
+    EXPECT_EQ(writer.writeNextPage(image.data()), 0);
+    EXPECT_EQ(eeprom.pagePrograms, 2);
+}
+
+TEST_F(PageWriterTest, skipsUnchangedPages)
+{
+    writer.markAll();
+    writer.writePendingPages(image.data());
+    eeprom.resetCounters();
+
+    auto changedImage = image;
+    EXPECT_FALSE(writer.hasPendingPages());
+
+    changedImage[ImageSize - 1]++;
+    writer.markChanged(ImageSize - 1, 1);
+    EXPECT_EQ(writer.getPendingPageCount(), 1);
+    writer.writePendingPages(changedImage.data());
+    EXPECT_EQ(eeprom.pagePrograms, 1);
+    EXPECT_EQ(readImage(), changedImage);
+}
+
+TEST_F(PageWriterTest, outOfImage)
+{
+    EXPECT_THROW(writer.markChanged(ImageSize - 1, 2), std::runtime_error);
+}
+} // namespace
@@ -0,0 +1,153 @@
+#include "TestSettings.hpp"
+#include "fake/CountingFakeEeprom.hpp"
+#include "fake/FakeClock.hpp"
+#include "settings-manager/SaveScheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace settings;
+using namespace std::chrono_literals;
+
+namespace
+{
+using Container = TestSettings::Container;
+using IO =
+    SettingsIO<TestSettings::EntryArray.size(), TestSettings::EntryArray, CountingFakeEeprom>;
+using Scheduler = SaveScheduler<IO, FakeClock>;
+
+class SaveSchedulerTest : public ::testing::Test
+{
+protected:
+    SaveSchedulerTest()
+    {
+        settingsIo.loadSettings();
+        eeprom.resetCounters();
+    }
+
+    CountingFakeEeprom eeprom{};
+    Container settingsContainer{};
+    IO settingsIo{eeprom, settingsContainer};
+    Scheduler scheduler{settingsIo, settingsContainer, Scheduler::Timing{100ms, 1s, 2s}};
+    size_t saveCount = 0;
+
+    /// polls every millisecond for duration
+    void run(FakeClock::duration duration)
+    {
+        for (FakeClock::duration elapsed{}; elapsed < duration; elapsed += 1ms)
+        {
+            FakeClock::current += 1ms;
+            eeprom.advanceTime(1ms);
+            saveCount += scheduler.poll() ? 1 : 0;
+        }
+    }
+
+    /// changes entry1 every period for duration
+    void tweak(FakeClock::duration duration, FakeClock::duration period)
+    {
+        for (FakeClock::duration elapsed{}; elapsed < duration; elapsed += period)
+        {
+            value = value >= TestSettings::Entry1_max ? TestSettings::Entry1_min : value + 1;
+            ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(value));
+            run(period);
+        }
+    }
+
+    void expectSaved()
+    {
+        Container reloaded;
+        IO otherIo{eeprom, reloaded};
+        EXPECT_TRUE(otherIo.loadSettings());
+        EXPECT_EQ(reloaded, settingsContainer);
+    }
+
+    SettingsValue_t value = TestSettings::Entry1_default;
+};
+
+TEST_F(SaveSchedulerTest, nothingChanged)
+{
+    run(5s);
+    EXPECT_EQ(saveCount, 0);
+    EXPECT_EQ(eeprom.writeCalls, 0);
+    EXPECT_FALSE(scheduler.isSavePending());
+}
+
+TEST_F(SaveSchedulerTest, savesAfterQuietPeriod)
+{
+    // a burst of changes, each one delays the save
+    tweak(500ms, 20ms);
+    EXPECT_EQ(saveCount, 0);
+    EXPECT_TRUE(scheduler.isSavePending());
+    EXPECT_EQ(eeprom.writeCalls, 0);
+
+    // the last change was polled 20ms ago
+    run(80ms);
+    EXPECT_EQ(saveCount, 0);
+    run(1ms);
+    EXPECT_EQ(saveCount, 1);
+    EXPECT_FALSE(scheduler.isSavePending());
+
+    // driven to its end by later polls
+    run(100ms);
+    EXPECT_FALSE(settingsIo.isBusy());
+    EXPECT_EQ(eeprom.accessesWhileBusy, 0);
+    expectSaved();
+}
+
+TEST_F(SaveSchedulerTest, savesAfterMaxDelay)
+{
+    // never quiet, saved after maxDelay, but minInterval apart
+    tweak(3s, 20ms);
+    EXPECT_EQ(saveCount, 1);
+    tweak(3s, 20ms);
+    EXPECT_EQ(saveCount, 3);
+    run(2s);
+    EXPECT_EQ(saveCount, 4);
+    expectSaved();
+}
+
+TEST_F(SaveSchedulerTest, rateLimited)
+{
+    tweak(20ms, 20ms);
+    run(200ms);
+    EXPECT_EQ(saveCount, 1);
+
+    // quiet, but the last save started less than minInterval ago
+    tweak(20ms, 20ms);
+    run(1s);
+    EXPECT_EQ(saveCount, 1);
+    EXPECT_TRUE(scheduler.isSavePending());
+    run(1s);
+    EXPECT_EQ(saveCount, 2);
+    run(100ms);
+    expectSaved();
+}
+
+TEST_F(SaveSchedulerTest, repeatedChangeOfOneSetting)
+{
+    // entry1 stays dirty, its changes still delay the save
+    tweak(50ms, 50ms);
+    tweak(50ms, 50ms);
+    tweak(50ms, 50ms);
+    EXPECT_EQ(saveCount, 0);
+    run(60ms);
+    EXPECT_EQ(saveCount, 1);
+}
+
+TEST_F(SaveSchedulerTest, flush)
+{
+    tweak(20ms, 20ms);
+    scheduler.flush();
+    EXPECT_FALSE(scheduler.isSavePending());
+    EXPECT_FALSE(settingsContainer.hasDirtyEntries());
+    expectSaved();
+    run(1s);
+    EXPECT_EQ(saveCount, 0);
+
+    // ignores the rate limit
+    tweak(20ms, 20ms);
+    scheduler.flush();
+    expectSaved();
+}
+} // namespace
@@ -0,0 +1,205 @@
+#include "TestSettings.hpp"
+#include "settings-manager/SettingsBinding.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+using namespace settings;
+using namespace TestSettings;
+
+namespace
+{
+struct Millimeters
+{
+    float value = 0;
+};
+
+struct MetersToMillimeters
+{
+    [[nodiscard]] Millimeters operator()(SettingsValue_t meters) const
+    {
+        return Millimeters{meters * 1000};
+    }
+};
+
+/// counts the values written to a binding
+struct CountingConversion
+{
+    size_t *count;
+
+    [[nodiscard]] SettingsValue_t operator()(SettingsValue_t value) const
+    {
+        ++*count;
+        return value;
+    }
+};
+
+/// Consumer reading its settings from plain members.
+class Consumer
+{
+public:
+    explicit Consumer(Container &settings)
+        : entry1Binding{settings, entry1},       //
+          entry2Binding{settings, entry2},       //
+          entry3Binding{settings, entry3},       //
+          integerBinding{settings, integer},     //
+          booleanBinding{settings, isEnabled}    //
+    {
+    }
+
+    SettingsValue_t entry1 = 0;
+    Millimeters entry2{};
+    std::atomic<double> entry3{0};
+    int32_t integer = 0;
+    bool isEnabled = false;
+
+private:
+    SettingsBinding<Container, Entry1> entry1Binding;
+    SettingsBinding<Container, Entry2, Millimeters, MetersToMillimeters> entry2Binding;
+    SettingsBinding<Container, Entry3, std::atomic<double>> entry3Binding;
+    SettingsBinding<Container, EntryInteger> integerBinding;
+    SettingsBinding<Container, EntryBoolean> booleanBinding;
+};
+
+class SettingsBindingTest : public ::testing::Test
+{
+protected:
+    Container settingsContainer;
+    Consumer consumer{settingsContainer};
+
+    void expectBound(const Consumer &bound) const
+    {
+        EXPECT_FLOAT_EQ(bound.entry1, settingsContainer.getValue<Entry1>());
+        EXPECT_FLOAT_EQ(bound.entry2.value, settingsContainer.getValue<Entry2>() * 1000);
+        EXPECT_DOUBLE_EQ(bound.entry3.load(), settingsContainer.getValue<Entry3>());
+        EXPECT_EQ(bound.integer, (settingsContainer.getValue<EntryInteger, int32_t>()));
+        EXPECT_EQ(bound.isEnabled, (settingsContainer.getValue<EntryBoolean, bool>()));
+    }
+};
+
+TEST_F(SettingsBindingTest, nativeTypes)
+{
+    static_assert(std::is_same_v<NativeValue_t<VariableType::realType>, SettingsValue_t>);
+    static_assert(std::is_same_v<NativeValue_t<VariableType::integerType>, int32_t>);
+    static_assert(std::is_same_v<NativeValue_t<VariableType::booleanType>, bool>);
+    static_assert(Container::getVariableType<EntryInteger>() == VariableType::integerType);
+}
+
+TEST_F(SettingsBindingTest, boundOnConstruction)
+{
+    EXPECT_FLOAT_EQ(consumer.entry1, Entry1_default);
+    EXPECT_FLOAT_EQ(consumer.entry2.value, Entry2_default * 1000);
+    EXPECT_EQ(consumer.integer, EntryInteger_default);
+    EXPECT_EQ(consumer.isEnabled, EntryBoolean_default);
+    expectBound(consumer);
+}
+
+TEST_F(SettingsBindingTest, setValue)
+{
+    EXPECT_TRUE(settingsContainer.setValue<Entry1>(Entry1_max));
+    EXPECT_FLOAT_EQ(consumer.entry1, Entry1_max);
+
+    EXPECT_TRUE(settingsContainer.setValue(Entry2, Entry2_min));
+    EXPECT_FLOAT_EQ(consumer.entry2.value, Entry2_min * 1000);
+
+    EXPECT_TRUE(settingsContainer.setValue(Container::getIndex<EntryInteger>(), 7));
+    EXPECT_EQ(consumer.integer, 7);
+
+    EXPECT_TRUE(settingsContainer.addToValue<Entry3>(1));
+    EXPECT_DOUBLE_EQ(consumer.entry3.load(), Entry3_default + 1);
+
+    EXPECT_TRUE(settingsContainer.setValue<EntryBoolean>(!EntryBoolean_default));
+    EXPECT_EQ(consumer.isEnabled, !EntryBoolean_default);
+
+    // rejected values aren't bound
+    EXPECT_FALSE(settingsContainer.setValue<Entry1>(Entry1_max + 1));
+    EXPECT_FLOAT_EQ(consumer.entry1, Entry1_max);
+    expectBound(consumer);
+}
+
+TEST_F(SettingsBindingTest, bulkWrites)
+{
+    EXPECT_TRUE((settingsContainer.setValues<Entry1, Entry2>({Entry1_min, Entry2_max})));
+    expectBound(consumer);
+
+    const std::array Batch = {IndexedValue{Container::getIndex<Entry3>(), Entry3_max},
+                              IndexedValue{Container::getIndex<EntryInteger>(), 1}};
+    EXPECT_TRUE(settingsContainer.setValues(Batch));
+    expectBound(consumer);
+
+    settingsContainer.resetAllToDefault();
+    expectBound(consumer);
+    EXPECT_FLOAT_EQ(consumer.entry1, Entry1_default);
+
+    // e.g. a load
+    Container other;
+    ASSERT_TRUE(other.setValue<Entry1>(Entry1_max));
+    ASSERT_TRUE(other.setValue<EntryBoolean>(!EntryBoolean_default));
+    Container::ValueArray values;
+    other.copyValuesTo(values);
+    settingsContainer.assignValues(values);
+    expectBound(consumer);
+
+    settingsContainer.resetAllToDefault();
+    settingsContainer = other;
+    expectBound(consumer);
+    EXPECT_FLOAT_EQ(consumer.entry1, Entry1_max);
+}
+
+TEST_F(SettingsBindingTest, unbindOnDestruction)
+{
+    auto first = std::make_unique<Consumer>(settingsContainer);
+    auto second = std::make_unique<Consumer>(settingsContainer);
+    auto third = std::make_unique<Consumer>(settingsContainer);
+
+    // first, middle and last of the list
+    second.reset();
+    EXPECT_TRUE(settingsContainer.setValue<Entry1>(Entry1_max));
+    third.reset();
+    EXPECT_TRUE(settingsContainer.setValue<Entry2>(Entry2_max));
+    expectBound(*first);
+    first.reset();
+    EXPECT_TRUE(settingsContainer.setValue<Entry3>(Entry3_max));
+    expectBound(consumer);
+}
+
+TEST_F(SettingsBindingTest, writesBindingsOfChangedSettingsOnly)
+{
+    size_t entry1Writes = 0;
+    size_t entry2Writes = 0;
+    SettingsValue_t entry1 = 0;
+    SettingsValue_t entry2 = 0;
+    SettingsBinding<Container, Entry1, SettingsValue_t, CountingConversion> entry1Binding{
+        settingsContainer, entry1, CountingConversion{&entry1Writes}};
+    SettingsBinding<Container, Entry2, SettingsValue_t, CountingConversion> entry2Binding{
+        settingsContainer, entry2, CountingConversion{&entry2Writes}};
+    ASSERT_EQ(entry1Writes, 1);
+    ASSERT_EQ(entry2Writes, 1);
+
+    EXPECT_TRUE(settingsContainer.setValue<Entry1>(Entry1_max));
+    EXPECT_EQ(entry1Writes, 2);
+    EXPECT_EQ(entry2Writes, 1);
+
+    // assigning a copy writes the bindings of the values differing only
+    Container other;
+    ASSERT_TRUE(other.setValue<Entry2>(Entry2_max));
+    settingsContainer = other;
+    EXPECT_EQ(entry1Writes, 3);
+    EXPECT_EQ(entry2Writes, 2);
+    EXPECT_FLOAT_EQ(entry1, Entry1_default);
+    EXPECT_FLOAT_EQ(entry2, Entry2_max);
+    settingsContainer = other;
+    EXPECT_EQ(entry1Writes, 3);
+    EXPECT_EQ(entry2Writes, 2);
+}
+
+TEST_F(SettingsBindingTest, copiesDontBind)
+{
+    Container copy{settingsContainer};
+    EXPECT_TRUE(copy.setValue<Entry1>(Entry1_max));
+    EXPECT_FLOAT_EQ(consumer.entry1, Entry1_default);
+}
+} // namespace
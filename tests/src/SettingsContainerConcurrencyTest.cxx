@@ -0,0 +1,120 @@
+#include "TestSettings.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace settings;
+
+namespace ConcurrentSettings
+{
+// the test settings as another table, read from several threads
+constexpr std::array EntryArray = TestSettings::EntryArray;
+constexpr size_t Count = EntryArray.size();
+} // namespace ConcurrentSettings
+
+template <>
+struct settings::ValueAccessOf<ConcurrentSettings::Count, ConcurrentSettings::EntryArray>
+{
+    using type = settings::SeqLockAccess;
+};
+
+namespace
+{
+using Container = SettingsContainer<ConcurrentSettings::Count, ConcurrentSettings::EntryArray>;
+static_assert(std::is_same_v<Container::Access, SeqLockAccess>);
+static_assert(std::is_same_v<TestSettings::Container::Access, PlainAccess>);
+
+TEST(SettingsContainerConcurrency, setAndGetValues)
+{
+    Container container;
+    ASSERT_TRUE((container.setValues<TestSettings::Entry1, TestSettings::Entry3>({50, 150})));
+    EXPECT_FLOAT_EQ(container.getValue<TestSettings::Entry1>(), 50);
+    EXPECT_FLOAT_EQ(container.getValue<TestSettings::Entry3>(), 150);
+    EXPECT_TRUE(container.getDirtyEntries().test(Container::getIndex<TestSettings::Entry1>()));
+    EXPECT_FALSE(container.getDirtyEntries().test(Container::getIndex<TestSettings::Entry2>()));
+
+    const auto Values = container.getValues<TestSettings::Entry3, TestSettings::Entry1>();
+    EXPECT_FLOAT_EQ(Values[0], 150);
+    EXPECT_FLOAT_EQ(Values[1], 50);
+
+    // all or nothing
+    EXPECT_FALSE((container.setValues<TestSettings::Entry1, TestSettings::Entry3>(
+        {60, TestSettings::Entry3_max + 1})));
+    EXPECT_FLOAT_EQ(container.getValue<TestSettings::Entry1>(), 50);
+}
+
+TEST(SettingsContainerConcurrency, copies)
+{
+    Container container;
+    ASSERT_TRUE(container.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    Container copy = container;
+    EXPECT_EQ(copy, container);
+    EXPECT_EQ(copy.getDirtyEntries(), container.getDirtyEntries());
+
+    ASSERT_TRUE(copy.setValue<TestSettings::Entry2>(TestSettings::Entry2_min));
+    EXPECT_NE(copy, container);
+    copy = container;
+    EXPECT_EQ(copy, container);
+}
+
+/// One writer publishes groups keeping Entry2 == 2 * Entry1 and Entry3 == 3 * Entry1, readers
+/// must never see a mix of two groups.
+TEST(SettingsContainerConcurrency, stress)
+{
+    constexpr size_t ReaderCount = 4;
+    constexpr size_t WriteCount = 50000;
+
+    Container container;
+    ASSERT_TRUE((container.setValues<TestSettings::Entry1, TestSettings::Entry2,
+                                     TestSettings::Entry3>({1, 2, 3})));
+
+    std::atomic<bool> isWriting{true};
+    std::atomic<size_t> tornReads{0};
+    std::atomic<size_t> reads{0};
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < ReaderCount; ++r)
+    {
+        readers.emplace_back(
+            [&]()
+            {
+                Container::ValueArray allValues;
+                while (isWriting.load())
+                {
+                    const auto Values =
+                        container.getValues<TestSettings::Entry1, TestSettings::Entry2,
+                                            TestSettings::Entry3>();
+                    container.copyValuesTo(allValues);
+                    const auto valueOf = [&](size_t index)
+                    {
+                        return Container::Layout::decode<SettingsValue_t>(
+                            index, Container::Layout::getRaw(allValues, index));
+                    };
+                    const bool IsTorn =
+                        Values[1] != 2 * Values[0] || Values[2] != 3 * Values[0] ||
+                        valueOf(1) != 2 * valueOf(0) || valueOf(2) != 3 * valueOf(0);
+                    tornReads += IsTorn ? 1 : 0;
+                    reads++;
+                }
+            });
+    }
+
+    for (size_t i = 0; i < WriteCount; ++i)
+    {
+        const SettingsValue_t Value = 1 + static_cast<SettingsValue_t>(i % 99);
+        ASSERT_TRUE((container.setValues<TestSettings::Entry1, TestSettings::Entry2,
+                                         TestSettings::Entry3>({Value, 2 * Value, 3 * Value})));
+    }
+    isWriting = false;
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_GT(reads.load(), 0);
+    EXPECT_EQ(tornReads.load(), 0);
+}
+} // namespace
@@ -114,6 +114,48 @@ TEST_F(SettingsContainerTest, setValues)
     EXPECT_FALSE(settingsContainer.setValue(entry1Index, Entry1_max + 1));
 }
 
+TEST_F(SettingsContainerTest, setValuesBatch)
+{
+    const size_t Entry1Index = settingsContainer.getIndex(Entry1);
+    const size_t EntryBooleanIndex = settingsContainer.getIndex(EntryBoolean);
+    const size_t EntryIntegerIndex = settingsContainer.getIndex(EntryInteger);
+
+    const std::array Profile = {
+        IndexedValue{Entry1Index, Entry1_max},
+        IndexedValue{EntryBooleanIndex, !EntryBoolean_default},
+        IndexedValue{EntryIntegerIndex, EntryInteger_default},
+    };
+    EXPECT_TRUE(settingsContainer.setValues(Profile));
+    EXPECT_FLOAT_EQ(settingsContainer.getValue<Entry1>(), Entry1_max);
+    EXPECT_EQ((settingsContainer.getValue<EntryBoolean, bool>()), !EntryBoolean_default);
+    // unchanged values aren't marked
+    EXPECT_EQ(settingsContainer.getDirtyEntries().count(), 2);
+    EXPECT_EQ(settingsContainer.getUnnotifiedEntries().count(), 2);
+    EXPECT_FALSE(settingsContainer.getDirtyEntries().test(EntryIntegerIndex));
+
+    // all or nothing
+    settingsContainer.clearDirtyEntries();
+    const std::array Invalid = {
+        IndexedValue{Entry1Index, Entry1_min},
+        IndexedValue{EntryIntegerIndex, EntryInteger_max + 1},
+    };
+    EXPECT_FALSE(settingsContainer.setValues(Invalid));
+    EXPECT_FLOAT_EQ(settingsContainer.getValue<Entry1>(), Entry1_max);
+    EXPECT_FALSE(settingsContainer.hasDirtyEntries());
+
+    // the last of duplicates wins
+    const std::array Duplicates = {
+        IndexedValue{Entry1Index, Entry1_min},
+        IndexedValue{Entry1Index, Entry1_default},
+    };
+    EXPECT_TRUE(settingsContainer.setValues(Duplicates.data(), Duplicates.size()));
+    EXPECT_FLOAT_EQ(settingsContainer.getValue<Entry1>(), Entry1_default);
+
+    EXPECT_TRUE(settingsContainer.setValues(nullptr, 0));
+    const IndexedValue OutOfRange{TestSettings::EntryArray.size(), 0};
+    EXPECT_THROW(settingsContainer.setValues(&OutOfRange, 1), std::runtime_error);
+}
+
 TEST_F(SettingsContainerTest, setGetValuesByIndex)
 {
     static constexpr auto entry1Index = Container::getIndex<Entry1>();
@@ -194,6 +236,17 @@ TEST_F(SettingsContainerTest, getMin_Default_MaxValue)
     ASSERT_EQ(settingsContainer.getMaxValue(entry3Index), Entry3_max);
 }
 
+TEST_F(SettingsContainerTest, getName)
+{
+    for (size_t i = 0; i < EntryArray.size(); ++i)
+    {
+        EXPECT_EQ(settingsContainer.getName(i), EntryArray[i].name);
+        EXPECT_EQ(settingsContainer.getIndex(settingsContainer.getName(i)), i);
+    }
+    EXPECT_THROW(static_cast<void>(settingsContainer.getName(EntryArray.size())),
+                 std::runtime_error);
+}
+
 TEST_F(SettingsContainerTest, addToValue)
 {
     EXPECT_TRUE(settingsContainer.addToValue(Entry1, 2));
@@ -226,4 +279,54 @@ TEST_F(SettingsContainerTest, addToValue)
     EXPECT_FALSE(settingsContainer.addToValue(Entry3, Entry3_max - Entry3_min - 1));
     EXPECT_FALSE(
         settingsContainer.addToValue(EntryInteger, EntryInteger_max - EntryInteger_min - 1));
+}
+
+TEST_F(SettingsContainerTest, copyAndAssignValues)
+{
+    using Layout = Container::Layout;
+    const auto getValueIn = [](const Container::ValueArray &values, size_t index)
+    { return Layout::decode<SettingsValue_t>(index, Layout::getRaw(values, index)); };
+    const auto setValueIn = [](Container::ValueArray &values, size_t index, SettingsValue_t value)
+    { Layout::setRaw(values, index, Layout::toRaw(index, value)); };
+
+    Container::ValueArray values{};
+    settingsContainer.copyValuesTo(values);
+    EXPECT_FLOAT_EQ(getValueIn(values, Container::getIndex<Entry1>()), Entry1_default);
+    EXPECT_FLOAT_EQ(getValueIn(values, Container::getIndex<Entry3>()), Entry3_default);
+
+    setValueIn(values, Container::getIndex<Entry1>(), Entry1_max);
+    setValueIn(values, Container::getIndex<Entry2>(), Entry2_max + 1); // out of bounds
+    setValueIn(values, Container::getIndex<Entry3>(), Entry3_min - 1); // out of bounds
+    EXPECT_EQ(settingsContainer.assignValues(values), 2);
+
+    EXPECT_FLOAT_EQ(settingsContainer.getValue(Entry1), Entry1_max);
+    EXPECT_FLOAT_EQ(settingsContainer.getValue(Entry2), Entry2_default);
+    EXPECT_FLOAT_EQ(settingsContainer.getValue(Entry3), Entry3_default);
+}
+
+TEST_F(SettingsContainerTest, dirtyEntries)
+{
+    constexpr auto Entry1Index = Container::getIndex<Entry1>();
+    constexpr auto Entry2Index = Container::getIndex<Entry2>();
+    EXPECT_FALSE(settingsContainer.hasDirtyEntries());
+
+    // same value, nothing changes
+    EXPECT_TRUE(settingsContainer.setValue(Entry1, Entry1_default));
+    EXPECT_FALSE(settingsContainer.hasDirtyEntries());
+
+    // out of bounds, nothing changes
+    EXPECT_FALSE(settingsContainer.setValue(Entry1, Entry1_max + 1));
+    EXPECT_FALSE(settingsContainer.hasDirtyEntries());
+
+    EXPECT_TRUE(settingsContainer.setValue(Entry1, Entry1_max));
+    EXPECT_TRUE(settingsContainer.addToValue(Entry2, 1));
+    EXPECT_TRUE(settingsContainer.getDirtyEntries().test(Entry1Index));
+    EXPECT_TRUE(settingsContainer.getDirtyEntries().test(Entry2Index));
+    EXPECT_EQ(settingsContainer.getDirtyEntries().count(), 2);
+
+    settingsContainer.clearDirtyEntries();
+    EXPECT_FALSE(settingsContainer.hasDirtyEntries());
+
+    settingsContainer.resetAllToDefault();
+    EXPECT_EQ(settingsContainer.getDirtyEntries().count(), 2);
 }
\ No newline at end of file
@@ -59,3 +59,22 @@ TEST_F(SettingsEntryTest, SameName)
     EXPECT_TRUE(entry.hasSameName(entry_otherValues_sameName.name));
     EXPECT_FALSE(entry.hasSameName(entry_otherName_sameValues.name));
 }
+
+TEST_F(SettingsEntryTest, mixedArguments)
+{
+    // integer literals next to a float pick the float constructor
+    constexpr SettingsEntry Real{0, 0.5f, 1, Name1, VariableType::realType};
+    static_assert(Real.defaultValue == 0.5f);
+
+    constexpr SettingsEntry Integer{0, 0x42, 0xFFFF, Name1, VariableType::integerType};
+    static_assert(Integer.defaultInteger == 0x42 && Integer.maxInteger == 0xFFFF);
+}
+
+TEST_F(SettingsEntryTest, exactIntegerBounds)
+{
+    // not representable as float
+    constexpr auto Entry = SettingsEntry::integer(-5, 16777217, INT32_MAX, Name1);
+    static_assert(Entry.variableType == VariableType::integerType);
+    static_assert(Entry.defaultInteger == 16777217 && Entry.maxInteger == INT32_MAX);
+    EXPECT_TRUE(Entry.isValid());
+}
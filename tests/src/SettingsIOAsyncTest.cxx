@@ -0,0 +1,157 @@
+#include "TestSettings.hpp"
+#include "fake/CountingFakeEeprom.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace settings;
+
+namespace
+{
+using Container = TestSettings::Container;
+using IO = settings::SettingsIO<TestSettings::EntryArray.size(), TestSettings::EntryArray,
+                                CountingFakeEeprom>;
+
+struct CompletionRecord
+{
+    size_t calls = 0;
+    bool success = false;
+
+    static void onCompletion(void *context, bool success)
+    {
+        auto record = static_cast<CompletionRecord *>(context);
+        record->calls++;
+        record->success = success;
+    }
+};
+
+class SettingsIOAsyncTest : public ::testing::Test
+{
+protected:
+    CountingFakeEeprom eeprom{};
+    Container settingsContainer{};
+    IO settingsIo{eeprom, settingsContainer};
+    CompletionRecord completion;
+
+    static constexpr size_t PageCount =
+        (sizeof(IO::EepromContent) + FakeEeprom::getPageSize() - 1) / FakeEeprom::getPageSize();
+
+    /// polls until done, every page takes one write cycle
+    size_t pollUntilDone()
+    {
+        size_t polls = 0;
+        while (settingsIo.poll())
+        {
+            eeprom.advanceTime(CountingFakeEeprom::WriteCycleTime / 2);
+            polls++;
+        }
+        return polls;
+    }
+};
+
+TEST_F(SettingsIOAsyncTest, loadFromEmptyEeprom)
+{
+    ASSERT_TRUE(settingsIo.startLoad(&CompletionRecord::onCompletion, &completion));
+    EXPECT_TRUE(settingsIo.isBusy());
+    pollUntilDone();
+
+    EXPECT_FALSE(settingsIo.isBusy());
+    EXPECT_EQ(completion.calls, 1);
+    EXPECT_FALSE(completion.success);
+    EXPECT_EQ(eeprom.accessesWhileBusy, 0);
+    // one more read of the header, looking for content of another settings table
+    EXPECT_EQ(eeprom.readCalls, PageCount + 1);
+    EXPECT_EQ(eeprom.pagePrograms, PageCount);
+
+    // defaults are written
+    Container otherContainer;
+    IO otherIo{eeprom, otherContainer};
+    EXPECT_TRUE(otherIo.loadSettings());
+}
+
+TEST_F(SettingsIOAsyncTest, loadValidContent)
+{
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    settingsIo.saveSettings();
+    settingsContainer.resetAllToDefault();
+    eeprom.resetCounters();
+
+    ASSERT_TRUE(settingsIo.startLoad(&CompletionRecord::onCompletion, &completion));
+    pollUntilDone();
+    EXPECT_EQ(completion.calls, 1);
+    EXPECT_TRUE(completion.success);
+    EXPECT_EQ(eeprom.writeCalls, 0);
+    EXPECT_FLOAT_EQ(settingsContainer.getValue<TestSettings::Entry2>(), TestSettings::Entry2_max);
+    EXPECT_FALSE(settingsContainer.hasDirtyEntries());
+}
+
+TEST_F(SettingsIOAsyncTest, saveOnePagePerStep)
+{
+    ASSERT_FALSE(settingsIo.loadSettings());
+    eeprom.advanceTime(CountingFakeEeprom::WriteCycleTime);
+    eeprom.resetCounters();
+
+    // header and the page of Entry3 change
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_max));
+    ASSERT_TRUE(settingsIo.startSave(&CompletionRecord::onCompletion, &completion));
+    EXPECT_EQ(eeprom.writeCalls, 0);
+
+    EXPECT_TRUE(settingsIo.poll());
+    EXPECT_EQ(eeprom.pagePrograms, 1);
+
+    // EEPROM busy, poll does nothing
+    EXPECT_TRUE(settingsIo.poll());
+    EXPECT_EQ(eeprom.pagePrograms, 1);
+
+    eeprom.advanceTime(CountingFakeEeprom::WriteCycleTime);
+    EXPECT_TRUE(settingsIo.poll());
+    EXPECT_EQ(eeprom.pagePrograms, 2);
+    EXPECT_EQ(completion.calls, 0);
+
+    eeprom.advanceTime(CountingFakeEeprom::WriteCycleTime);
+    EXPECT_FALSE(settingsIo.poll());
+    EXPECT_EQ(eeprom.pagePrograms, 2);
+    EXPECT_EQ(eeprom.accessesWhileBusy, 0);
+    EXPECT_EQ(completion.calls, 1);
+    EXPECT_TRUE(completion.success);
+}
+
+TEST_F(SettingsIOAsyncTest, saveUsesSnapshot)
+{
+    ASSERT_FALSE(settingsIo.loadSettings());
+
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    ASSERT_TRUE(settingsIo.startSave());
+
+    // changes while saving are not part of the running save
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_min));
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_min));
+    pollUntilDone();
+
+    Container otherContainer;
+    IO otherIo{eeprom, otherContainer};
+    ASSERT_TRUE(otherIo.loadSettings());
+    EXPECT_FLOAT_EQ(otherContainer.getValue<TestSettings::Entry1>(), TestSettings::Entry1_max);
+    EXPECT_FLOAT_EQ(otherContainer.getValue<TestSettings::Entry3>(),
+                    TestSettings::Entry3_default);
+
+    // but are still dirty for the next save
+    EXPECT_EQ(settingsContainer.getDirtyEntries().count(), 2);
+    settingsIo.saveChangedSettings();
+    ASSERT_TRUE(otherIo.loadSettings());
+    EXPECT_EQ(otherContainer, settingsContainer);
+}
+
+TEST_F(SettingsIOAsyncTest, rejectsConcurrentOperations)
+{
+    ASSERT_TRUE(settingsIo.startLoad());
+    EXPECT_FALSE(settingsIo.startLoad());
+    EXPECT_FALSE(settingsIo.startSave());
+    EXPECT_THROW(settingsIo.saveSettings(), std::runtime_error);
+    EXPECT_THROW(settingsIo.loadSettings(), std::runtime_error);
+    pollUntilDone();
+
+    EXPECT_TRUE(settingsIo.startSave());
+    pollUntilDone();
+    EXPECT_FALSE(settingsIo.poll());
+}
+} // namespace
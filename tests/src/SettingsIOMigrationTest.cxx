@@ -0,0 +1,378 @@
+#include "fake/CountingFakeEeprom.hpp"
+#include "settings-manager/SettingsContainer.hpp"
+#include "settings-manager/SettingsIO.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace settings;
+
+namespace
+{
+constexpr std::string_view Gain = "gain";
+constexpr std::string_view Address = "address";
+constexpr std::string_view IsInverted = "isInverted";
+constexpr std::string_view Offset = "offset";
+constexpr std::string_view IsEnabled = "isEnabled";
+constexpr std::string_view Added = "added";
+constexpr std::string_view IsAdded = "isAdded";
+
+/// settings table of the old firmware
+namespace Original
+{
+constexpr std::array EntryArray = {
+    SettingsEntry{0.0f, 10.0f, 100.0f, Gain},
+    SettingsEntry{0, 5, 1000, Address, VariableType::integerType},
+    SettingsEntry{false, IsInverted},
+    SettingsEntry{-10.0f, 0.0f, 10.0f, Offset},
+    SettingsEntry{true, IsEnabled},
+};
+} // namespace Original
+
+namespace Reordered
+{
+constexpr std::array EntryArray = {
+    SettingsEntry{-10.0f, 0.0f, 10.0f, Offset},
+    SettingsEntry{true, IsEnabled},
+    SettingsEntry{0.0f, 10.0f, 100.0f, Gain},
+    SettingsEntry{false, IsInverted},
+    SettingsEntry{0, 5, 1000, Address, VariableType::integerType},
+};
+} // namespace Reordered
+
+namespace Inserted
+{
+constexpr std::array EntryArray = {
+    SettingsEntry{0.0f, 10.0f, 100.0f, Gain},
+    SettingsEntry{0.0f, 7.0f, 10.0f, Added},
+    SettingsEntry{0, 5, 1000, Address, VariableType::integerType},
+    SettingsEntry{false, IsInverted},
+    SettingsEntry{-10.0f, 0.0f, 10.0f, Offset},
+    SettingsEntry{true, IsEnabled},
+    SettingsEntry{true, IsAdded},
+};
+} // namespace Inserted
+
+namespace Removed
+{
+constexpr std::array EntryArray = {
+    SettingsEntry{0, 5, 1000, Address, VariableType::integerType},
+    SettingsEntry{true, IsEnabled},
+};
+} // namespace Removed
+
+namespace Retyped
+{
+// address became a real, gain got a smaller range
+constexpr std::array EntryArray = {
+    SettingsEntry{0.0f, 10.0f, 20.0f, Gain},
+    SettingsEntry{0.0f, 5.0f, 1000.0f, Address},
+    SettingsEntry{false, IsInverted},
+    SettingsEntry{-10.0f, 0.0f, 10.0f, Offset},
+    SettingsEntry{true, IsEnabled},
+};
+} // namespace Retyped
+
+namespace Rebounded
+{
+// address got another min and more bits
+constexpr std::array EntryArray = {
+    SettingsEntry{0.0f, 10.0f, 100.0f, Gain},
+    SettingsEntry{-100, 5, 5000, Address, VariableType::integerType},
+    SettingsEntry{false, IsInverted},
+    SettingsEntry{-10.0f, 0.0f, 10.0f, Offset},
+    SettingsEntry{true, IsEnabled},
+};
+} // namespace Rebounded
+
+template <const auto &entryArray, size_t SlotCount = 1, class Format = NativeFormat>
+struct Table
+{
+    using Container = SettingsContainer<entryArray.size(), entryArray>;
+    using IO = SettingsIO<entryArray.size(), entryArray, CountingFakeEeprom, SlotCount,
+                          FnvIntegrity, Format>;
+    /// most bytes read by a load without migration
+    static constexpr size_t LoadedSize = SlotCount * sizeof(typename IO::EepromContent);
+};
+
+template <size_t SlotCount = 1, class Format = NativeFormat>
+using OriginalTable = Table<Original::EntryArray, SlotCount, Format>;
+
+class SettingsIOMigrationTest : public ::testing::Test
+{
+protected:
+    CountingFakeEeprom eeprom{};
+
+    /// saves non default values with the original table
+    template <size_t SlotCount = 1, class Format = NativeFormat>
+    void saveOriginal(float gain = 42.0f)
+    {
+        typename OriginalTable<SlotCount, Format>::Container container;
+        typename OriginalTable<SlotCount, Format>::IO io{eeprom, container};
+        ASSERT_FALSE(io.loadSettings());
+        ASSERT_TRUE(container.template setValue<Gain>(gain));
+        ASSERT_TRUE(container.template setValue<Address>(777));
+        ASSERT_TRUE(container.template setValue<IsInverted>(true));
+        ASSERT_TRUE(container.template setValue<Offset>(-3.5f));
+        ASSERT_TRUE(container.template setValue<IsEnabled>(false));
+        io.saveSettings();
+    }
+
+    /// loads with another table, the migrated content is saved in its layout
+    template <class NewTable>
+    typename NewTable::Container load(bool expectedResult = true)
+    {
+        typename NewTable::Container container;
+        typename NewTable::IO io{eeprom, container};
+        EXPECT_EQ(io.loadSettings(), expectedResult);
+
+        typename NewTable::Container reloaded;
+        typename NewTable::IO otherIo{eeprom, reloaded};
+        const size_t BytesBefore = eeprom.bytesRead;
+        EXPECT_TRUE(otherIo.loadSettings());
+        EXPECT_LE(eeprom.bytesRead - BytesBefore, NewTable::LoadedSize)
+            << "no migration on the second load";
+        EXPECT_EQ(reloaded, container);
+        return container;
+    }
+};
+
+TEST_F(SettingsIOMigrationTest, settingsTable)
+{
+    using IO = OriginalTable<>::IO;
+    static_assert(IO::getOtherContentSize(Original::EntryArray.size(), 4 * sizeof(uint32_t)) ==
+                  sizeof(IO::EepromContent));
+
+    IO::EepromContent content;
+    EXPECT_EQ(content.settingsEntryCount, 5);
+    // three words and one of booleans
+    EXPECT_EQ(content.settingsValuesSize, 4 * sizeof(uint32_t));
+    EXPECT_EQ(content.settingsEntryHashes[2],
+              static_cast<uint32_t>(Original::EntryArray[1].NameHash));
+    EXPECT_EQ(content.settingsEntryHashes[3], Original::EntryArray[1].NameHash >> 32);
+    // types 2 bit each: real, integer, boolean, real, boolean
+    EXPECT_EQ(content.settingsEntryTypes[0], 0b10'01'10'00'01);
+    EXPECT_NE(IO::hashSettingsNames(), Table<Reordered::EntryArray>::IO::hashSettingsNames());
+}
+
+TEST_F(SettingsIOMigrationTest, reorder)
+{
+    saveOriginal();
+    const auto Container = load<Table<Reordered::EntryArray>>();
+    EXPECT_FLOAT_EQ(Container.getValue<Gain>(), 42.0f);
+    EXPECT_EQ((Container.getValue<Address, int>()), 777);
+    EXPECT_TRUE((Container.getValue<IsInverted, bool>()));
+    EXPECT_FLOAT_EQ(Container.getValue<Offset>(), -3.5f);
+    EXPECT_FALSE((Container.getValue<IsEnabled, bool>()));
+}
+
+TEST_F(SettingsIOMigrationTest, insert)
+{
+    saveOriginal();
+    const auto Container = load<Table<Inserted::EntryArray>>();
+    EXPECT_FLOAT_EQ(Container.getValue<Gain>(), 42.0f);
+    EXPECT_EQ((Container.getValue<Address, int>()), 777);
+    EXPECT_TRUE((Container.getValue<IsInverted, bool>()));
+    EXPECT_FLOAT_EQ(Container.getValue<Offset>(), -3.5f);
+    EXPECT_FALSE((Container.getValue<IsEnabled, bool>()));
+
+    // new entries get their defaults
+    EXPECT_FLOAT_EQ(Container.getValue<Added>(), 7.0f);
+    EXPECT_TRUE((Container.getValue<IsAdded, bool>()));
+}
+
+TEST_F(SettingsIOMigrationTest, remove)
+{
+    saveOriginal();
+    const auto Container = load<Table<Removed::EntryArray>>();
+    EXPECT_EQ((Container.getValue<Address, int>()), 777);
+    EXPECT_FALSE((Container.getValue<IsEnabled, bool>()));
+
+    // and back, the removed entries are lost
+    const auto Restored = load<OriginalTable<>>();
+    EXPECT_EQ((Restored.getValue<Address, int>()), 777);
+    EXPECT_FALSE((Restored.getValue<IsEnabled, bool>()));
+    EXPECT_FLOAT_EQ(Restored.getValue<Gain>(), 10.0f);
+    EXPECT_FALSE((Restored.getValue<IsInverted, bool>()));
+}
+
+TEST_F(SettingsIOMigrationTest, changedTypeAndBounds)
+{
+    saveOriginal();
+    const auto Container = load<Table<Retyped::EntryArray>>();
+    // another type can't be migrated, out of bounds values are reset
+    EXPECT_FLOAT_EQ(Container.getValue<Address>(), 5.0f);
+    EXPECT_FLOAT_EQ(Container.getValue<Gain>(), 10.0f);
+    EXPECT_TRUE((Container.getValue<IsInverted, bool>()));
+    EXPECT_FLOAT_EQ(Container.getValue<Offset>(), -3.5f);
+}
+
+TEST_F(SettingsIOMigrationTest, newestSlot)
+{
+    saveOriginal<2>(1.0f);
+    {
+        OriginalTable<2>::Container container;
+        OriginalTable<2>::IO io{eeprom, container};
+        ASSERT_TRUE(io.loadSettings());
+        ASSERT_TRUE(container.setValue<Gain>(2.0f));
+        io.saveSettings();
+    }
+
+    const auto Container = load<Table<Inserted::EntryArray, 2>>();
+    EXPECT_FLOAT_EQ(Container.getValue<Gain>(), 2.0f);
+    EXPECT_EQ((Container.getValue<Address, int>()), 777);
+}
+
+TEST_F(SettingsIOMigrationTest, interruptedFirstSave)
+{
+    // slots: defaults with generation 1, gain 1 with 2, gain 2 with 3 in slot 0
+    saveOriginal<2>(1.0f);
+    {
+        OriginalTable<2>::Container container;
+        OriginalTable<2>::IO io{eeprom, container};
+        ASSERT_TRUE(io.loadSettings());
+        ASSERT_TRUE(container.setValue<Gain>(2.0f));
+        io.saveSettings();
+    }
+
+    // power loss after the first page of the migrated content
+    using NewTable = Table<Inserted::EntryArray, 2>;
+    {
+        NewTable::Container container;
+        NewTable::IO io{eeprom, container};
+        eeprom.resetCounters();
+        ASSERT_TRUE(io.startLoad());
+        while (eeprom.writeCalls == 0 && io.poll())
+        {
+            eeprom.advanceTime(CountingFakeEeprom::WriteCycleTime);
+        }
+        ASSERT_EQ(eeprom.writeCalls, 1);
+        EXPECT_GE(eeprom.lastWriteAddress, NewTable::IO::getSlotOffset(1))
+            << "slot 0 holds the newest source";
+    }
+
+    // the source is intact
+    OriginalTable<2>::Container original;
+    OriginalTable<2>::IO originalIo{eeprom, original};
+    EXPECT_TRUE(originalIo.loadSettings());
+    EXPECT_FLOAT_EQ(original.getValue<Gain>(), 2.0f);
+
+    const auto Container = load<NewTable>();
+    EXPECT_FLOAT_EQ(Container.getValue<Gain>(), 2.0f);
+    EXPECT_EQ((Container.getValue<Address, int>()), 777);
+
+    // the generation continues the one of the source
+    NewTable::IO::EepromContent content;
+    eeprom.read(NewTable::IO::getSlotOffset(1), reinterpret_cast<uint8_t *>(&content),
+                sizeof(content));
+    EXPECT_EQ(content.generation, 4);
+}
+
+TEST_F(SettingsIOMigrationTest, corruptNewestSlot)
+{
+    saveOriginal<2>(1.0f);
+    {
+        OriginalTable<2>::Container container;
+        OriginalTable<2>::IO io{eeprom, container};
+        ASSERT_TRUE(io.loadSettings());
+        ASSERT_TRUE(container.setValue<Gain>(2.0f));
+        io.saveSettings();
+    }
+
+    // slots: defaults with generation 1, gain 1 with 2, gain 2 with 3 in slot 0
+    using IO = OriginalTable<2>::IO;
+    uint8_t value;
+    const size_t ValueOffset = IO::getSlotOffset(0) + IO::HeaderSize;
+    eeprom.read(ValueOffset, &value, 1);
+    value ^= 1;
+    eeprom.write(ValueOffset, &value, 1);
+
+    const auto Container = load<Table<Removed::EntryArray, 2>>();
+    EXPECT_EQ((Container.getValue<Address, int>()), 777);
+}
+
+TEST_F(SettingsIOMigrationTest, corruptSettingsTable)
+{
+    saveOriginal();
+    using IO = OriginalTable<>::IO;
+    uint8_t hashByte;
+    const size_t HashOffset = IO::MemoryOffset + offsetof(IO::EepromContent, settingsEntryHashes);
+    eeprom.read(HashOffset, &hashByte, 1);
+    hashByte ^= 1;
+    eeprom.write(HashOffset, &hashByte, 1);
+
+    const auto Container = load<Table<Reordered::EntryArray>>(false);
+    EXPECT_EQ(Container, Table<Reordered::EntryArray>::Container{});
+}
+
+TEST_F(SettingsIOMigrationTest, compactSettingsTable)
+{
+    using IO = OriginalTable<1, CompactFormat>::IO;
+    // 32 + 10 + 1 + 32 + 1 bits
+    static_assert(IO::getOtherContentSize(Original::EntryArray.size(), 10) ==
+                  sizeof(IO::EepromContent));
+
+    IO::EepromContent content;
+    EXPECT_EQ(content.settingsValuesSize, 10);
+    // NameHash, min raw and bit width per entry
+    EXPECT_EQ(content.settingsEntryHashes[4],
+              static_cast<uint32_t>(Original::EntryArray[1].NameHash));
+    EXPECT_EQ(content.settingsEntryHashes[5], Original::EntryArray[1].NameHash >> 32);
+    EXPECT_EQ(content.settingsEntryHashes[6], 0);
+    EXPECT_EQ(content.settingsEntryHashes[7], 10);
+    EXPECT_EQ(content.settingsEntryHashes[3], 32) << "gain";
+    EXPECT_EQ(content.settingsEntryHashes[11], 1) << "isInverted";
+
+    // other bounds change the layout of the values
+    EXPECT_NE(IO::hashSettingsNames(),
+              (Table<Rebounded::EntryArray, 1, CompactFormat>::IO::hashSettingsNames()));
+}
+
+TEST_F(SettingsIOMigrationTest, compactFormat)
+{
+    saveOriginal<2, CompactFormat>();
+    const auto Container = load<Table<Inserted::EntryArray, 2, CompactFormat>>();
+    EXPECT_FLOAT_EQ(Container.getValue<Gain>(), 42.0f);
+    EXPECT_EQ((Container.getValue<Address, int>()), 777);
+    EXPECT_TRUE((Container.getValue<IsInverted, bool>()));
+    EXPECT_FLOAT_EQ(Container.getValue<Offset>(), -3.5f);
+    EXPECT_FALSE((Container.getValue<IsEnabled, bool>()));
+    EXPECT_FLOAT_EQ(Container.getValue<Added>(), 7.0f);
+    EXPECT_TRUE((Container.getValue<IsAdded, bool>()));
+}
+
+TEST_F(SettingsIOMigrationTest, compactFormatBounds)
+{
+    saveOriginal<1, CompactFormat>();
+    using NewTable = Table<Rebounded::EntryArray, 1, CompactFormat>;
+    const auto Container = load<NewTable>();
+    EXPECT_FLOAT_EQ(Container.getValue<Gain>(), 42.0f);
+    EXPECT_EQ((Container.getValue<Address, int>()), 777);
+    EXPECT_TRUE((Container.getValue<IsInverted, bool>()));
+    EXPECT_FLOAT_EQ(Container.getValue<Offset>(), -3.5f);
+
+    // and back with the original bounds
+    const auto Restored = load<OriginalTable<1, CompactFormat>>();
+    EXPECT_EQ((Restored.getValue<Address, int>()), 777);
+    EXPECT_FLOAT_EQ(Restored.getValue<Offset>(), -3.5f);
+}
+
+TEST_F(SettingsIOMigrationTest, streamingLoad)
+{
+    saveOriginal<2>();
+
+    using NewTable = Table<Inserted::EntryArray, 2>;
+    using ScratchIO = SettingsIO<Inserted::EntryArray.size(), Inserted::EntryArray,
+                                 CountingFakeEeprom, 2, FnvIntegrity, NativeFormat, ScratchImage>;
+    ScratchIO::ImageBuffer scratch;
+    NewTable::Container container;
+    ScratchIO io{eeprom, container, scratch};
+    EXPECT_TRUE(io.loadSettingsStreaming());
+    EXPECT_FLOAT_EQ(container.getValue<Gain>(), 42.0f);
+    EXPECT_FLOAT_EQ(container.getValue<Added>(), 7.0f);
+
+    NewTable::Container reloaded;
+    NewTable::IO otherIo{eeprom, reloaded};
+    EXPECT_TRUE(otherIo.loadSettings());
+    EXPECT_EQ(reloaded, container);
+}
+} // namespace
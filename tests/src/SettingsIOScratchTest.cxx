@@ -0,0 +1,198 @@
+#include "TestSettings.hpp"
+#include "fake/CountingFakeEeprom.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace settings;
+
+namespace
+{
+using Container = TestSettings::Container;
+using IO = SettingsIO<TestSettings::EntryArray.size(), TestSettings::EntryArray,
+                      CountingFakeEeprom, 2>;
+using ScratchIO = SettingsIO<TestSettings::EntryArray.size(), TestSettings::EntryArray,
+                             CountingFakeEeprom, 2, FnvIntegrity, NativeFormat, ScratchImage>;
+
+class SettingsIOScratchTest : public ::testing::Test
+{
+protected:
+    CountingFakeEeprom eeprom{};
+    Container settingsContainer{};
+    ScratchIO::ImageBuffer scratch{};
+    ScratchIO settingsIo{eeprom, settingsContainer, scratch};
+
+    /// loads from empty EEPROM and fills both slots, which differ in entry1 only
+    void fillSlots()
+    {
+        EXPECT_FALSE(settingsIo.loadSettings());
+        ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+        settingsIo.saveSettings();
+    }
+
+    /// simulates other users of the scratch buffer
+    void clobberScratch()
+    {
+        scratch.bytes.fill(0xA5);
+    }
+
+    Container loadOther()
+    {
+        Container otherContainer;
+        IO otherIo{eeprom, otherContainer};
+        EXPECT_TRUE(otherIo.loadSettings());
+        return otherContainer;
+    }
+};
+
+TEST_F(SettingsIOScratchTest, noOwnImage)
+{
+    static_assert(sizeof(ScratchIO) + sizeof(IO::ImageBuffer) - sizeof(void *) <= sizeof(IO));
+    static_assert(sizeof(ScratchIO::ImageBuffer) == sizeof(IO::ImageBuffer));
+}
+
+TEST_F(SettingsIOScratchTest, saveWithClobberedScratch)
+{
+    fillSlots();
+    clobberScratch();
+
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_min));
+    eeprom.resetCounters();
+    settingsIo.saveSettings();
+    // slots are read again, only the page with header and entry1 is written
+    EXPECT_EQ(eeprom.bytesRead, 2 * sizeof(IO::EepromContent));
+    EXPECT_EQ(eeprom.pagePrograms, 1);
+    EXPECT_EQ(loadOther(), settingsContainer);
+
+    clobberScratch();
+    eeprom.resetCounters();
+    settingsIo.saveChangedSettings();
+    EXPECT_EQ(eeprom.pagePrograms, 0);
+}
+
+TEST_F(SettingsIOScratchTest, alternatingSlots)
+{
+    EXPECT_FALSE(settingsIo.loadSettings());
+    for (int i = 0; i < 3; ++i)
+    {
+        clobberScratch();
+        ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_min + i));
+        settingsIo.saveSettings();
+        EXPECT_EQ(loadOther(), settingsContainer);
+    }
+
+    IO::EepromContent first;
+    IO::EepromContent second;
+    eeprom.read(IO::getSlotOffset(0), reinterpret_cast<uint8_t *>(&first), sizeof(first));
+    eeprom.read(IO::getSlotOffset(1), reinterpret_cast<uint8_t *>(&second), sizeof(second));
+    EXPECT_EQ(first.generation, 3);
+    EXPECT_EQ(second.generation, 4);
+}
+
+TEST_F(SettingsIOScratchTest, asyncSave)
+{
+    fillSlots();
+    clobberScratch();
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_min));
+    eeprom.resetCounters();
+
+    bool isDone = false;
+    const auto onDone = [](void *context, bool) { *static_cast<bool *>(context) = true; };
+    ASSERT_TRUE(settingsIo.startSave(onDone, &isDone));
+    // nothing is touched before the first poll
+    EXPECT_EQ(eeprom.readCalls, 0);
+    while (settingsIo.poll())
+    {
+        eeprom.advanceTime(CountingFakeEeprom::WriteCycleTime);
+    }
+    EXPECT_TRUE(isDone);
+    EXPECT_EQ(eeprom.accessesWhileBusy, 0);
+    EXPECT_EQ(eeprom.bytesRead, 2 * sizeof(IO::EepromContent));
+    EXPECT_EQ(eeprom.pagePrograms, 1);
+    EXPECT_EQ(loadOther(), settingsContainer);
+}
+
+TEST_F(SettingsIOScratchTest, streamingLoad)
+{
+    fillSlots();
+    const Container Saved = settingsContainer;
+
+    Container otherContainer;
+    ScratchIO otherIo{eeprom, otherContainer, scratch};
+    clobberScratch();
+    eeprom.resetCounters();
+    EXPECT_TRUE(otherIo.loadSettingsStreaming());
+    EXPECT_EQ(otherContainer, Saved);
+    EXPECT_EQ(otherContainer.getDirtyEntries().count(), 0);
+
+    // headers of both slots and the values of the newest one, nothing to write back
+    EXPECT_EQ(eeprom.bytesRead, 2 * offsetof(IO::EepromContent, settingsValues) +
+                                    sizeof(IO::EepromContent::settingsValues));
+    EXPECT_EQ(eeprom.writeCalls, 0);
+}
+
+TEST_F(SettingsIOScratchTest, streamingLoadCompactFormat)
+{
+    using CompactIO = SettingsIO<TestSettings::EntryArray.size(), TestSettings::EntryArray,
+                                 CountingFakeEeprom, 2, FnvIntegrity, CompactFormat, ScratchImage>;
+    CompactIO::ImageBuffer compactScratch{};
+    CompactIO compactIo{eeprom, settingsContainer, compactScratch};
+    EXPECT_FALSE(compactIo.loadSettings());
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    compactIo.saveSettings();
+
+    // decoded from the image of the format
+    Container otherContainer;
+    CompactIO otherIo{eeprom, otherContainer, compactScratch};
+    EXPECT_TRUE(otherIo.loadSettingsStreaming());
+    EXPECT_EQ(otherContainer, settingsContainer);
+}
+
+TEST_F(SettingsIOScratchTest, streamingLoadFromEmptyEeprom)
+{
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    EXPECT_FALSE(settingsIo.loadSettingsStreaming());
+    EXPECT_EQ(settingsContainer, Container{});
+
+    // defaults are written
+    EXPECT_EQ(loadOther(), Container{});
+}
+
+TEST_F(SettingsIOScratchTest, streamingLoadCorruptNewestSlot)
+{
+    fillSlots();
+
+    // slot 1 holds the newest values, slot 0 the defaults
+    IO::EepromContent newest;
+    eeprom.read(IO::getSlotOffset(1), reinterpret_cast<uint8_t *>(&newest), sizeof(newest));
+    newest.settingsValues[0] ^= 1;
+    eeprom.write(IO::getSlotOffset(1), reinterpret_cast<uint8_t *>(&newest), sizeof(newest));
+
+    Container otherContainer;
+    ScratchIO otherIo{eeprom, otherContainer, scratch};
+    EXPECT_TRUE(otherIo.loadSettingsStreaming());
+    EXPECT_EQ(otherContainer, Container{});
+}
+
+TEST_F(SettingsIOScratchTest, streamingLoadOutOfBounds)
+{
+    fillSlots();
+
+    IO::EepromContent newest;
+    eeprom.read(IO::getSlotOffset(1), reinterpret_cast<uint8_t *>(&newest), sizeof(newest));
+    Container::Layout::setRaw(
+        newest.settingsValues, Container::getIndex<TestSettings::Entry2>(),
+        Container::Layout::toRaw(Container::getIndex<TestSettings::Entry2>(),
+                                 TestSettings::Entry2_max + 1));
+    newest.settingsValuesHash = IO::hashSettingsValues(newest.settingsValues, newest.generation);
+    eeprom.write(IO::getSlotOffset(1), reinterpret_cast<uint8_t *>(&newest), sizeof(newest));
+
+    Container otherContainer;
+    ScratchIO otherIo{eeprom, otherContainer, scratch};
+    EXPECT_TRUE(otherIo.loadSettingsStreaming());
+    EXPECT_FLOAT_EQ(otherContainer.getValue<TestSettings::Entry2>(), TestSettings::Entry2_default);
+    EXPECT_FLOAT_EQ(otherContainer.getValue<TestSettings::Entry1>(), TestSettings::Entry1_max);
+
+    // corrected value is written back
+    EXPECT_EQ(loadOther(), otherContainer);
+}
+} // namespace
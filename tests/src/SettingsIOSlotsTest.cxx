@@ -0,0 +1,177 @@
+#include "TestSettings.hpp"
+#include "fake/CountingFakeEeprom.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace settings;
+
+namespace
+{
+using Container = TestSettings::Container;
+using IO = settings::SettingsIO<TestSettings::EntryArray.size(), TestSettings::EntryArray,
+                                CountingFakeEeprom, 2>;
+
+class SettingsIOSlotsTest : public ::testing::Test
+{
+protected:
+    CountingFakeEeprom eeprom{};
+    Container settingsContainer{};
+    IO settingsIo{eeprom, settingsContainer};
+
+    IO::EepromContent readSlot(size_t slot)
+    {
+        IO::EepromContent content;
+        eeprom.read(IO::getSlotOffset(slot), reinterpret_cast<uint8_t *>(&content),
+                    sizeof(IO::EepromContent));
+        return content;
+    }
+
+    void writeSlot(size_t slot, IO::EepromContent content)
+    {
+        eeprom.write(IO::getSlotOffset(slot), reinterpret_cast<uint8_t *>(&content),
+                     sizeof(IO::EepromContent));
+    }
+
+    /// loads with a fresh container
+    Container loadOther(bool expectedResult = true)
+    {
+        Container otherContainer;
+        IO otherIo{eeprom, otherContainer};
+        EXPECT_EQ(otherIo.loadSettings(), expectedResult);
+        return otherContainer;
+    }
+};
+
+TEST_F(SettingsIOSlotsTest, slotLayout)
+{
+    static_assert(IO::SlotSize % IO::PageSize == 0);
+    static_assert(IO::SlotSize >= sizeof(IO::EepromContent));
+    static_assert(IO::getSlotOffset(1) == IO::MemoryOffset + IO::SlotSize);
+}
+
+TEST_F(SettingsIOSlotsTest, alternatingSlots)
+{
+    // fresh EEPROM, defaults go to the first slot
+    ASSERT_FALSE(settingsIo.loadSettings());
+    EXPECT_EQ(readSlot(0).generation, 1);
+    EXPECT_EQ(eeprom.lastWriteAddress + eeprom.lastWriteLength,
+              IO::getSlotOffset(0) + sizeof(IO::EepromContent));
+
+    // next save goes to the second slot, first one stays untouched
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    const auto FirstSlot = readSlot(0);
+    eeprom.resetCounters();
+    settingsIo.saveChangedSettings();
+    EXPECT_EQ(readSlot(0), FirstSlot);
+    EXPECT_EQ(readSlot(1).generation, 2);
+    EXPECT_EQ(eeprom.pagePrograms, eeprom.writeCalls);
+    EXPECT_EQ(loadOther(), settingsContainer);
+
+    // and back to the first one
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_max));
+    settingsIo.saveSettings();
+    EXPECT_EQ(readSlot(0).generation, 3);
+    EXPECT_EQ(loadOther(), settingsContainer);
+
+    // nothing changed, nothing written
+    eeprom.resetCounters();
+    settingsIo.saveSettings();
+    settingsIo.saveChangedSettings();
+    EXPECT_EQ(eeprom.writeCalls, 0);
+}
+
+TEST_F(SettingsIOSlotsTest, slotsReadOnceOnLoad)
+{
+    ASSERT_FALSE(settingsIo.loadSettings());
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    settingsIo.saveSettings();
+    eeprom.resetCounters();
+    loadOther();
+    // header and values at once, the settings table in chunks, nothing between the slots
+    constexpr size_t TableSize =
+        sizeof(IO::EepromContent) - offsetof(IO::EepromContent, settingsEntryTypes);
+    constexpr size_t ChunkCount = (TableSize + IO::StreamChunkSize - 1) / IO::StreamChunkSize;
+    EXPECT_EQ(eeprom.readCalls, 2 * (1 + ChunkCount));
+    EXPECT_EQ(eeprom.bytesRead, 2 * sizeof(IO::EepromContent));
+}
+
+TEST_F(SettingsIOSlotsTest, interruptedSaveKeepsPreviousSettings)
+{
+    ASSERT_FALSE(settingsIo.loadSettings());
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    settingsIo.saveSettings();
+    const Container SavedContainer = settingsContainer;
+
+    // power loss during the save into the first slot, only the first page made it
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_min));
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_min));
+    ASSERT_TRUE(settingsIo.startSave());
+    EXPECT_TRUE(settingsIo.poll());
+
+    // newest complete slot is used
+    const Container Loaded = loadOther();
+    EXPECT_EQ(Loaded, SavedContainer);
+    EXPECT_FLOAT_EQ(Loaded.getValue<TestSettings::Entry1>(), TestSettings::Entry1_max);
+}
+
+TEST_F(SettingsIOSlotsTest, corruptedSlot)
+{
+    ASSERT_FALSE(settingsIo.loadSettings());
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    settingsIo.saveSettings();
+
+    // newest slot corrupted, older one is used
+    auto content = readSlot(1);
+    content.settingsValues[0]++;
+    writeSlot(1, content);
+    EXPECT_FLOAT_EQ(loadOther().getValue<TestSettings::Entry2>(), TestSettings::Entry2_default);
+
+    // both corrupted, reset to defaults
+    content = readSlot(0);
+    content.magicString = content.magicString + 1;
+    writeSlot(0, content);
+    loadOther(false);
+}
+
+TEST_F(SettingsIOSlotsTest, generationWrapAround)
+{
+    ASSERT_FALSE(settingsIo.loadSettings());
+
+    auto older = readSlot(0);
+    older.generation = 0xFFFFFFFF;
+    older.settingsValuesHash = IO::hashSettingsValues(older.settingsValues, older.generation);
+    writeSlot(0, older);
+
+    auto newer = older;
+    newer.generation = 0;
+    constexpr auto Entry2Index = Container::getIndex<TestSettings::Entry2>();
+    Container::Layout::setRaw(newer.settingsValues, Entry2Index,
+                              Container::Layout::toRaw(Entry2Index, TestSettings::Entry2_max));
+    newer.settingsValuesHash = IO::hashSettingsValues(newer.settingsValues, newer.generation);
+    writeSlot(1, newer);
+
+    EXPECT_FLOAT_EQ(loadOther().getValue<TestSettings::Entry2>(), TestSettings::Entry2_max);
+
+    // next save overwrites the older slot
+    ASSERT_TRUE(settingsIo.loadSettings());
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_max));
+    settingsIo.saveSettings();
+    EXPECT_EQ(readSlot(0).generation, 1);
+    EXPECT_EQ(readSlot(1), newer);
+}
+
+TEST_F(SettingsIOSlotsTest, asyncLoad)
+{
+    ASSERT_FALSE(settingsIo.loadSettings());
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    settingsIo.saveSettings();
+    settingsContainer.resetAllToDefault();
+
+    ASSERT_TRUE(settingsIo.startLoad());
+    while (settingsIo.poll())
+    {
+        eeprom.advanceTime(CountingFakeEeprom::WriteCycleTime);
+    }
+    EXPECT_FLOAT_EQ(settingsContainer.getValue<TestSettings::Entry2>(), TestSettings::Entry2_max);
+}
+} // namespace
@@ -0,0 +1,210 @@
+#include "TestSettings.hpp"
+#include "fake/CountingFakeEeprom.hpp"
+#include "fake/FakeClock.hpp"
+#include "settings-manager/IoStatistics.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <type_traits>
+
+using namespace settings;
+
+namespace
+{
+/// Blocks in write() until its write cycles are done, like a driver polling the EEPROM.
+class BlockingEeprom : public CountingFakeEeprom
+{
+public:
+    void write(AddressSize address, const uint8_t *data, size_t length) override
+    {
+        const auto BusyBefore = busyTime;
+        CountingFakeEeprom::write(address, data, length);
+        FakeClock::current += busyTime - BusyBefore;
+        advanceTime(busyTime - BusyBefore);
+    }
+};
+
+using Statistics = IoStatistics<FakeClock>;
+using Container = TestSettings::Container;
+template <size_t SlotCount = 1, class ImageStorage = OwnedImage>
+using InstrumentedIO =
+    SettingsIO<TestSettings::EntryArray.size(), TestSettings::EntryArray, BlockingEeprom, SlotCount,
+               FnvIntegrity, NativeFormat, ImageStorage, Statistics>;
+using IO = InstrumentedIO<>;
+
+/// same names and types as TestSettings, but a smaller range of entry2
+constexpr std::array NarrowEntryArray = {
+    SettingsEntry{TestSettings::Entry1_min, TestSettings::Entry1_default,
+                  TestSettings::Entry1_max, TestSettings::Entry1},
+    SettingsEntry{TestSettings::Entry2_min, TestSettings::Entry2_default,
+                  TestSettings::Entry2_default, TestSettings::Entry2},
+    TestSettings::EntryArray[2],
+    TestSettings::EntryArray[3],
+    TestSettings::EntryArray[4],
+};
+
+class SettingsIOStatisticsTest : public ::testing::Test
+{
+protected:
+    BlockingEeprom eeprom{};
+    Container settingsContainer{};
+    IO settingsIo{eeprom, settingsContainer};
+
+    void expectEepromTraffic(const Statistics &statistics)
+    {
+        EXPECT_EQ(statistics.bytesRead, eeprom.bytesRead);
+        EXPECT_EQ(statistics.bytesWritten, eeprom.bytesWritten);
+        EXPECT_EQ(statistics.pagePrograms, eeprom.pagePrograms);
+    }
+
+    /// bypasses the counters
+    void corruptByte(size_t offset)
+    {
+        uint8_t byte;
+        eeprom.FakeEeprom::read(offset, &byte, 1);
+        byte ^= 1;
+        eeprom.FakeEeprom::write(offset, &byte, 1);
+    }
+};
+
+TEST_F(SettingsIOStatisticsTest, disabledByDefault)
+{
+    static_assert(std::is_empty_v<NoStatistics>);
+    static_assert(sizeof(TestSettings::IO) < sizeof(SettingsIO<TestSettings::EntryArray.size(),
+                                                               TestSettings::EntryArray, FakeEeprom,
+                                                               1, FnvIntegrity, NativeFormat,
+                                                               OwnedImage, Statistics>));
+}
+
+TEST_F(SettingsIOStatisticsTest, loadAndSave)
+{
+    EXPECT_FALSE(settingsIo.loadSettings());
+    const auto &Statistics = settingsIo.getStatistics();
+    EXPECT_EQ(Statistics.loadCount, 1);
+    EXPECT_EQ(Statistics.signatureFailures, 1);
+    EXPECT_EQ(Statistics.saveCount, 0);
+    expectEepromTraffic(Statistics);
+
+    // the write back of defaults is not a save
+    EXPECT_GT(Statistics.pagePrograms, 0);
+    EXPECT_EQ(Statistics.lastSaveDuration.count(), 0);
+
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    const size_t PagesBefore = eeprom.pagePrograms;
+    settingsIo.saveSettings();
+    EXPECT_EQ(Statistics.saveCount, 1);
+    expectEepromTraffic(Statistics);
+    EXPECT_EQ(Statistics.lastSaveDuration,
+              CountingFakeEeprom::WriteCycleTime * (eeprom.pagePrograms - PagesBefore));
+    EXPECT_EQ(Statistics.maxSaveDuration, Statistics.lastSaveDuration);
+
+    // nothing to write
+    settingsIo.saveChangedSettings();
+    EXPECT_EQ(Statistics.saveCount, 2);
+    EXPECT_EQ(Statistics.lastSaveDuration.count(), 0);
+    EXPECT_GT(Statistics.maxSaveDuration.count(), 0);
+
+    EXPECT_TRUE(settingsIo.loadSettings());
+    EXPECT_EQ(Statistics.loadCount, 2);
+    EXPECT_EQ(Statistics.signatureFailures, 1);
+    EXPECT_EQ(Statistics.namesHashFailures + Statistics.valuesHashFailures, 0);
+    expectEepromTraffic(Statistics);
+}
+
+TEST_F(SettingsIOStatisticsTest, valuesHashFailure)
+{
+    settingsIo.saveSettings();
+    corruptByte(IO::MemoryOffset + IO::HeaderSize);
+
+    EXPECT_FALSE(settingsIo.loadSettings());
+    EXPECT_EQ(settingsIo.getStatistics().valuesHashFailures, 1);
+    EXPECT_EQ(settingsIo.getStatistics().signatureFailures, 0);
+}
+
+TEST_F(SettingsIOStatisticsTest, namesHashFailure)
+{
+    settingsIo.saveSettings();
+    corruptByte(IO::MemoryOffset + offsetof(IO::EepromContent, settingsNamesHash));
+
+    EXPECT_FALSE(settingsIo.loadSettings());
+    EXPECT_EQ(settingsIo.getStatistics().namesHashFailures, 1);
+    expectEepromTraffic(settingsIo.getStatistics());
+}
+
+TEST_F(SettingsIOStatisticsTest, furthestCheckOfSlots)
+{
+    Container container;
+    InstrumentedIO<2> io{eeprom, container};
+    io.saveSettings();
+    ASSERT_TRUE(container.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    io.saveSettings();
+    corruptByte(InstrumentedIO<2>::getSlotOffset(0) +
+                offsetof(InstrumentedIO<2>::EepromContent, magicString));
+    corruptByte(InstrumentedIO<2>::getSlotOffset(1) + InstrumentedIO<2>::HeaderSize);
+
+    // slot 0 fails the signature, slot 1 passes all checks but the values hash
+    EXPECT_FALSE(io.loadSettings());
+    EXPECT_EQ(io.getStatistics().valuesHashFailures, 1);
+    EXPECT_EQ(io.getStatistics().signatureFailures, 0);
+}
+
+TEST_F(SettingsIOStatisticsTest, outOfRangeLoad)
+{
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    settingsIo.saveSettings();
+
+    SettingsContainer<NarrowEntryArray.size(), NarrowEntryArray> narrowContainer;
+    SettingsIO<NarrowEntryArray.size(), NarrowEntryArray, BlockingEeprom, 1, FnvIntegrity,
+               NativeFormat, OwnedImage, Statistics>
+        narrowIo{eeprom, narrowContainer};
+    EXPECT_TRUE(narrowIo.loadSettings());
+    EXPECT_EQ(narrowIo.getStatistics().outOfRangeLoads, 1);
+    EXPECT_EQ(narrowIo.getStatistics().loadCount, 1);
+}
+
+TEST_F(SettingsIOStatisticsTest, asynchronousSave)
+{
+    settingsIo.saveSettings();
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    const auto MaxBefore = settingsIo.getStatistics().maxSaveDuration;
+
+    ASSERT_TRUE(settingsIo.startSave());
+    while (settingsIo.poll())
+    {
+        FakeClock::current += std::chrono::milliseconds{1};
+    }
+    const auto &Statistics = settingsIo.getStatistics();
+    EXPECT_EQ(Statistics.saveCount, 2);
+    expectEepromTraffic(Statistics);
+    // waiting between polls is part of the save
+    EXPECT_GT(Statistics.lastSaveDuration, MaxBefore);
+    EXPECT_EQ(Statistics.maxSaveDuration, Statistics.lastSaveDuration);
+
+    // an asynchronous load is no save
+    ASSERT_TRUE(settingsIo.startLoad());
+    while (settingsIo.poll())
+    {
+    }
+    EXPECT_EQ(Statistics.loadCount, 1);
+    EXPECT_EQ(Statistics.saveCount, 2);
+    expectEepromTraffic(Statistics);
+}
+
+TEST_F(SettingsIOStatisticsTest, streamingLoad)
+{
+    using ScratchIO = InstrumentedIO<2, ScratchImage>;
+    ScratchIO::ImageBuffer scratch;
+    ScratchIO io{eeprom, settingsContainer, scratch};
+
+    EXPECT_FALSE(io.loadSettingsStreaming());
+    EXPECT_EQ(io.getStatistics().signatureFailures, 1);
+    EXPECT_EQ(io.getStatistics().saveCount, 0);
+
+    corruptByte(ScratchIO::getSlotOffset(0) + ScratchIO::HeaderSize);
+    EXPECT_FALSE(io.loadSettingsStreaming());
+    EXPECT_EQ(io.getStatistics().valuesHashFailures, 1);
+    EXPECT_EQ(io.getStatistics().loadCount, 2);
+    expectEepromTraffic(io.getStatistics());
+}
+} // namespace
@@ -1,4 +1,5 @@
 #include "TestSettings.hpp"
+#include "fake/CountingFakeEeprom.hpp"
 #include "fake/FakeEeprom.hpp"
 #include <array>
 #include <core/hash.hpp>
@@ -31,10 +32,33 @@ protected:
     OffsetEntry_t NamesHashOffset;
     OffsetEntry_t ValuesHashOffset;
     OffsetEntry_t MagicStringOffset;
-    OffsetEntry_t SettingsContainerOffset;
+    OffsetEntry_t GenerationOffset;
+    OffsetEntry_t EntryCountOffset;
+    OffsetEntry_t ValuesSizeOffset;
+    OffsetEntry_t SettingsValuesOffset;
+    OffsetEntry_t EntryTypesOffset;
+    OffsetEntry_t EntryHashesOffset;
     // keep size in line with number of OffsetEntry_t above, too big array will fail asserts in
     // loadEepromContentOffsets
-    std::array<OffsetEntry_t, 4> allOffsets;
+    std::array<OffsetEntry_t, 9> allOffsets;
+
+    static IO::ValueArray valuesOf(const Container &container)
+    {
+        IO::ValueArray values{};
+        container.copyValuesTo(values);
+        return values;
+    }
+
+    static void setValueIn(IO::ValueArray &values, size_t index, SettingsValue_t value)
+    {
+        Container::Layout::setRaw(values, index, Container::Layout::toRaw(index, value));
+    }
+
+    static SettingsValue_t getValueIn(const IO::ValueArray &values, size_t index)
+    {
+        return Container::Layout::decode<SettingsValue_t>(index,
+                                                          Container::Layout::getRaw(values, index));
+    }
 };
 
 void SettingsIOTest::loadEepromContentOffsets()
@@ -55,11 +79,32 @@ void SettingsIOTest::loadEepromContentOffsets()
     MagicStringOffset = std::pair(reinterpret_cast<Offset_t>(&temporaryContent.magicString) -
                                       reinterpret_cast<Offset_t>(&temporaryContent),
                                   0);
-    SettingsContainerOffset =
-        std::pair(reinterpret_cast<Offset_t>(&temporaryContent.settingsContainer) -
+    GenerationOffset = std::pair(reinterpret_cast<Offset_t>(&temporaryContent.generation) -
+                                     reinterpret_cast<Offset_t>(&temporaryContent),
+                                 0);
+    EntryCountOffset =
+        std::pair(reinterpret_cast<Offset_t>(&temporaryContent.settingsEntryCount) -
+                      reinterpret_cast<Offset_t>(&temporaryContent),
+                  0);
+    ValuesSizeOffset =
+        std::pair(reinterpret_cast<Offset_t>(&temporaryContent.settingsValuesSize) -
+                      reinterpret_cast<Offset_t>(&temporaryContent),
+                  0);
+    SettingsValuesOffset =
+        std::pair(reinterpret_cast<Offset_t>(&temporaryContent.settingsValues) -
                       reinterpret_cast<Offset_t>(&temporaryContent),
                   0);
-    allOffsets = {NamesHashOffset, ValuesHashOffset, MagicStringOffset, SettingsContainerOffset};
+    EntryTypesOffset =
+        std::pair(reinterpret_cast<Offset_t>(&temporaryContent.settingsEntryTypes) -
+                      reinterpret_cast<Offset_t>(&temporaryContent),
+                  0);
+    EntryHashesOffset =
+        std::pair(reinterpret_cast<Offset_t>(&temporaryContent.settingsEntryHashes) -
+                      reinterpret_cast<Offset_t>(&temporaryContent),
+                  0);
+    allOffsets = {NamesHashOffset,      ValuesHashOffset,     MagicStringOffset,
+                  GenerationOffset,     EntryCountOffset,     ValuesSizeOffset,
+                  SettingsValuesOffset, EntryTypesOffset,     EntryHashesOffset};
 
     // not the same offsets, offsets sorted ascending
     Offset_t accumulatedSize = 0;
@@ -79,8 +124,8 @@ void SettingsIOTest::loadEepromContentOffsets()
     allOffsets[allOffsets.size() - 1].second =
         sizeof(IO::EepromContent) - allOffsets[allOffsets.size() - 1].first;
 
-    // every member of struct is targeted, assuming settingsContainer is last
-    ASSERT_EQ(accumulatedSize + sizeof(IO::EepromContent::settingsContainer),
+    // every member of struct is targeted, assuming settingsEntryHashes is last
+    ASSERT_EQ(accumulatedSize + sizeof(IO::EepromContent::settingsEntryHashes),
               sizeof(IO::EepromContent));
 }
 
@@ -92,7 +137,7 @@ TEST_F(SettingsIOTest, initFromEmptyEeprom)
     settingsIo.loadSettings();
     eeprom.read(IO::MemoryOffset, reinterpret_cast<uint8_t *>(&temporaryContent),
                 sizeof(IO::EepromContent));
-    ASSERT_EQ(temporaryContent.settingsContainer, settingsContainer);
+    ASSERT_EQ(temporaryContent.settingsValues, valuesOf(settingsContainer));
 }
 
 TEST_F(SettingsIOTest, initFromDefaultEeprom)
@@ -105,13 +150,13 @@ TEST_F(SettingsIOTest, initFromDefaultEeprom)
     // change a setting, so we can spot if default values are read again later
     static_assert(TestSettings::Entry1_min != TestSettings::Entry1_default);
     settingsContainer.setValue(TestSettings::Entry1, TestSettings::Entry1_min);
-    EXPECT_NE(temporaryContent.settingsContainer, settingsContainer);
+    EXPECT_NE(temporaryContent.settingsValues, valuesOf(settingsContainer));
 
     // restore default eeprom and check if we are back to default
     eeprom.write(IO::MemoryOffset, reinterpret_cast<uint8_t *>(&temporaryContent),
                  sizeof(IO::EepromContent));
     ASSERT_TRUE(settingsIo.loadSettings());
-    EXPECT_EQ(temporaryContent.settingsContainer, settingsContainer);
+    EXPECT_EQ(temporaryContent.settingsValues, valuesOf(settingsContainer));
 }
 
 TEST_F(SettingsIOTest, initFromCorruptedEeprom)
@@ -145,6 +190,27 @@ TEST_F(SettingsIOTest, initFromCorruptedEeprom)
     }
 }
 
+TEST_F(SettingsIOTest, settingsTableFromFlash)
+{
+    // the image holds header and values only
+    static_assert(sizeof(IO::ImageBuffer) == offsetof(IO::EepromContent, settingsEntryTypes));
+    ASSERT_FALSE(settingsIo.loadSettings());
+    eeprom.read(IO::MemoryOffset, reinterpret_cast<uint8_t *>(&temporaryContent),
+                sizeof(IO::EepromContent));
+    EXPECT_EQ(temporaryContent.settingsEntryTypes, IO::EntryTypes);
+    EXPECT_EQ(temporaryContent.settingsEntryHashes, IO::EntryHashes);
+
+    // a damaged table is written again
+    temporaryContent.settingsEntryHashes.back() = temporaryContent.settingsEntryHashes.back() + 1;
+    eeprom.write(IO::MemoryOffset, reinterpret_cast<uint8_t *>(&temporaryContent),
+                 sizeof(IO::EepromContent));
+    ASSERT_FALSE(settingsIo.loadSettings());
+    eeprom.read(IO::MemoryOffset, reinterpret_cast<uint8_t *>(&temporaryContent),
+                sizeof(IO::EepromContent));
+    EXPECT_EQ(temporaryContent.settingsEntryHashes, IO::EntryHashes);
+    EXPECT_TRUE(settingsIo.loadSettings());
+}
+
 TEST_F(SettingsIOTest, saveSettings)
 {
     // init eeprom content, which fills it with default values and saves
@@ -157,7 +223,8 @@ TEST_F(SettingsIOTest, saveSettings)
     ASSERT_EQ(settingsContainer.getValue(TestSettings::Entry1), TestSettings::Entry1_default);
     settingsContainer.setValue(TestSettings::Entry1, TestSettings::Entry1_min);
     ASSERT_EQ(settingsContainer.getValue(TestSettings::Entry1), TestSettings::Entry1_min);
-    EXPECT_NE(temporaryContent.settingsContainer, settingsContainer); // applying setting worked
+    // applying setting worked
+    EXPECT_NE(temporaryContent.settingsValues, valuesOf(settingsContainer));
 
     // assure altered content is saved
     IO::EepromContent alteredContent;
@@ -171,7 +238,8 @@ TEST_F(SettingsIOTest, EepromContentEquality)
 {
     ASSERT_EQ(temporaryContent, temporaryContent);
     auto other = temporaryContent;
-    other.settingsContainer.setValue(TestSettings::Entry1, TestSettings::Entry1_min);
+    setValueIn(other.settingsValues, Container::getIndex<TestSettings::Entry1>(),
+               TestSettings::Entry1_min);
     ASSERT_NE(temporaryContent, other);
 }
 
@@ -193,14 +261,12 @@ TEST_F(SettingsIOTest, BoundsCheckFailOnLoad)
     // reset to defaults
 
     // change a setting outside of bounds
-    auto rawData = reinterpret_cast<SettingsValue_t *>(&temporaryContent.settingsContainer);
-    ASSERT_LT(temporaryContent.settingsContainer.getValue(TestSettings::Entry1),
-              TestSettings::Entry1_max);
-    rawData[0] = TestSettings::Entry1_max + static_cast<SettingsValue_t>(1);
-    ASSERT_GT(temporaryContent.settingsContainer.getValue(TestSettings::Entry1),
-              TestSettings::Entry1_max);
+    constexpr auto Entry1Index = Container::getIndex<TestSettings::Entry1>();
+    ASSERT_LT(getValueIn(temporaryContent.settingsValues, Entry1Index), TestSettings::Entry1_max);
+    setValueIn(temporaryContent.settingsValues, Entry1Index,
+               TestSettings::Entry1_max + static_cast<SettingsValue_t>(1));
     temporaryContent.settingsValuesHash =
-        IO::hashSettingsValues(temporaryContent.settingsContainer);
+        IO::hashSettingsValues(temporaryContent.settingsValues, temporaryContent.generation);
 
     // write back to eeprom
     eeprom.write(IO::MemoryOffset, reinterpret_cast<uint8_t *>(&temporaryContent),
@@ -211,4 +277,117 @@ TEST_F(SettingsIOTest, BoundsCheckFailOnLoad)
 
     // check if reset to default worked
     ASSERT_EQ(settingsContainer.getValue(TestSettings::Entry1), TestSettings::Entry1_default);
-}
\ No newline at end of file
+}
+
+TEST_F(SettingsIOTest, NoNameLookupsOnLoadSave)
+{
+    // loading, saving and hashing work on indices / the whole value array, so their cost is
+    // linear in the number of settings and no name is ever looked up
+    const auto LookupsBefore = TestSettings::NameLookups::lookupCount;
+
+    ASSERT_FALSE(settingsIo.loadSettings());
+    settingsIo.saveSettings();
+    ASSERT_TRUE(settingsIo.loadSettings());
+    [[maybe_unused]] const auto Hash = IO::hashSettingsValues(valuesOf(settingsContainer), 0);
+
+    EXPECT_EQ(TestSettings::NameLookups::lookupCount, LookupsBefore);
+
+    [[maybe_unused]] const auto Index = settingsContainer.getIndex(TestSettings::Entry1);
+    EXPECT_EQ(TestSettings::NameLookups::lookupCount, LookupsBefore + 1);
+}
+
+TEST_F(SettingsIOTest, ValuesHash)
+{
+    // hashing the value array at once equals hashing every value followed by the generation
+    IO::ValueArray values = valuesOf(settingsContainer);
+    constexpr uint32_t Generation = 42;
+    uint64_t hash = core::hash::HASH_SEED;
+    for (const auto &value : values)
+    {
+        const auto ptr = reinterpret_cast<const uint8_t *>(&value);
+        hash = core::hash::fnvWithSeed(hash, ptr, ptr + sizeof(value));
+    }
+    const auto ptr = reinterpret_cast<const uint8_t *>(&Generation);
+    hash = core::hash::fnvWithSeed(hash, ptr, ptr + sizeof(Generation));
+    EXPECT_EQ(IO::hashSettingsValues(values, Generation), hash);
+    EXPECT_NE(IO::hashSettingsValues(values, Generation + 1), hash);
+}
+
+TEST_F(SettingsIOTest, saveChangedSettings)
+{
+    CountingFakeEeprom countingEeprom;
+    IO io{countingEeprom, settingsContainer};
+    constexpr auto PageSize = FakeEeprom::getPageSize();
+    constexpr auto HeaderSize = offsetof(IO::EepromContent, settingsValues);
+    constexpr auto TableOffset = offsetof(IO::EepromContent, settingsEntryTypes);
+    static_assert(HeaderSize <= PageSize && TableOffset <= 2 * PageSize &&
+                      sizeof(IO::EepromContent) > 2 * PageSize,
+                  "test expects the header in the first page, values in the second one and the "
+                  "settings table to end in the third one");
+
+    ASSERT_FALSE(io.loadSettings());
+    ASSERT_FALSE(settingsContainer.hasDirtyEntries());
+
+    // nothing changed, nothing to write
+    countingEeprom.resetCounters();
+    io.saveChangedSettings();
+    io.saveSettings();
+    EXPECT_EQ(countingEeprom.writeCalls, 0);
+
+    // value in the second page changed, written together with the header page, the settings
+    // table is left alone
+    constexpr auto Entry3Index = Container::getIndex<TestSettings::Entry3>();
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_max));
+    EXPECT_TRUE(settingsContainer.getDirtyEntries().test(Entry3Index));
+    io.saveChangedSettings();
+    EXPECT_FALSE(settingsContainer.hasDirtyEntries());
+    EXPECT_EQ(countingEeprom.writeCalls, 2);
+    EXPECT_EQ(countingEeprom.pagePrograms, 2);
+    EXPECT_EQ(countingEeprom.bytesWritten, 2 * PageSize);
+
+    // incremental save results in the same content as a full save
+    IO::EepromContent incrementalContent;
+    countingEeprom.read(IO::MemoryOffset, reinterpret_cast<uint8_t *>(&incrementalContent),
+                        sizeof(IO::EepromContent));
+    Container otherContainer;
+    IO otherIo{countingEeprom, otherContainer};
+    ASSERT_TRUE(otherIo.loadSettings());
+    EXPECT_EQ(otherContainer, settingsContainer);
+    otherIo.saveSettings();
+    countingEeprom.read(IO::MemoryOffset, reinterpret_cast<uint8_t *>(&temporaryContent),
+                        sizeof(IO::EepromContent));
+    EXPECT_EQ(incrementalContent, temporaryContent);
+
+    // value changed back and forth, nothing to write
+    countingEeprom.resetCounters();
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_min));
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_max));
+    io.saveChangedSettings();
+    EXPECT_EQ(countingEeprom.writeCalls, 0);
+
+    // another value of the second page, again header and values page only
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    io.saveChangedSettings();
+    EXPECT_EQ(countingEeprom.writeCalls, 2);
+    EXPECT_EQ(countingEeprom.pagePrograms, 2);
+    EXPECT_EQ(countingEeprom.busyTime, 2 * CountingFakeEeprom::WriteCycleTime);
+
+    ASSERT_TRUE(otherIo.loadSettings());
+    EXPECT_EQ(otherContainer, settingsContainer);
+}
+
+TEST_F(SettingsIOTest, saveBeforeLoad)
+{
+    // EEPROM content unknown, every page is written
+    CountingFakeEeprom countingEeprom;
+    IO io{countingEeprom, settingsContainer};
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    io.saveChangedSettings();
+    EXPECT_EQ(countingEeprom.bytesWritten, sizeof(IO::EepromContent));
+    EXPECT_EQ(countingEeprom.pagePrograms, countingEeprom.writeCalls);
+
+    Container otherContainer;
+    IO otherIo{countingEeprom, otherContainer};
+    ASSERT_TRUE(otherIo.loadSettings());
+    EXPECT_FLOAT_EQ(otherContainer.getValue<TestSettings::Entry1>(), TestSettings::Entry1_max);
+}
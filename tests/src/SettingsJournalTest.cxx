@@ -0,0 +1,405 @@
+#include "TestSettings.hpp"
+#include "fake/CountingFakeEeprom.hpp"
+#include "fake/FakeClock.hpp"
+#include "settings-manager/IoStatistics.hpp"
+#include "settings-manager/SettingsJournal.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace settings;
+
+namespace
+{
+using Container = TestSettings::Container;
+using Journal = settings::SettingsJournal<TestSettings::EntryArray.size(), TestSettings::EntryArray,
+                                         CountingFakeEeprom, 2>;
+
+class SettingsJournalTest : public ::testing::Test
+{
+protected:
+    CountingFakeEeprom eeprom{};
+    Container settingsContainer{};
+    Journal::ImageBuffer scratch{};
+    Journal journal{eeprom, settingsContainer, scratch};
+
+    /// loads with a fresh container and journal
+    Container loadOther(bool expectedResult = true)
+    {
+        Container otherContainer;
+        Journal otherJournal{eeprom, otherContainer, scratch};
+        EXPECT_EQ(otherJournal.loadSettings(), expectedResult);
+        return otherContainer;
+    }
+
+    Journal::Record readRecord(size_t position)
+    {
+        Journal::Record record;
+        eeprom.read(Journal::getRecordOffset(position), reinterpret_cast<uint8_t *>(&record),
+                    sizeof(Journal::Record));
+        return record;
+    }
+
+    void writeRecord(size_t position, Journal::Record record)
+    {
+        eeprom.write(Journal::getRecordOffset(position), reinterpret_cast<uint8_t *>(&record),
+                     sizeof(Journal::Record));
+    }
+};
+
+TEST_F(SettingsJournalTest, layout)
+{
+    static_assert(Journal::RecordCount == 2 * CountingFakeEeprom::getPageSize() / 8);
+    static_assert(Journal::Capacity == Journal::RecordCount - 1);
+    static_assert(Journal::RequiredMemorySize == Journal::JournalOffset + 2 * 32);
+    static_assert(Journal::RequiredMemorySize <= CountingFakeEeprom::getSizeInBytes());
+}
+
+TEST_F(SettingsJournalTest, loadDefaults)
+{
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    EXPECT_FALSE(journal.loadSettings());
+    EXPECT_EQ(settingsContainer, Container{});
+    EXPECT_EQ(journal.getGeneration(), 1);
+    EXPECT_EQ(journal.getJournalStart(), 0);
+    EXPECT_EQ(journal.getJournalLength(), 0);
+
+    // the marker starts the journal of the new generation
+    const auto Marker = readRecord(0);
+    EXPECT_EQ(Marker.index, Journal::MarkerIndex);
+    EXPECT_EQ(Marker.check, Journal::checkRecord(1, 0, Marker));
+
+    EXPECT_EQ(loadOther(), Container{});
+}
+
+TEST_F(SettingsJournalTest, appendSingleRecord)
+{
+    ASSERT_FALSE(journal.loadSettings());
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+
+    eeprom.resetCounters();
+    journal.saveSettings();
+    EXPECT_EQ(eeprom.writeCalls, 1);
+    EXPECT_EQ(eeprom.bytesWritten, sizeof(Journal::Record));
+    EXPECT_EQ(eeprom.pagePrograms, 1);
+    EXPECT_EQ(eeprom.lastWriteAddress, Journal::getRecordOffset(1));
+    EXPECT_EQ(journal.getJournalLength(), 1);
+
+    // nothing changed, nothing written
+    eeprom.resetCounters();
+    journal.saveSettings();
+    journal.saveChangedSettings();
+    EXPECT_EQ(eeprom.writeCalls, 0);
+
+    EXPECT_EQ(loadOther(), settingsContainer);
+}
+
+TEST_F(SettingsJournalTest, recordsSharingAPage)
+{
+    ASSERT_FALSE(journal.loadSettings());
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    journal.saveChangedSettings();
+
+    // four records at positions 2 to 5, crossing the page border after the second one
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_min));
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_max));
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::EntryInteger>(0));
+    eeprom.resetCounters();
+    journal.saveChangedSettings();
+    EXPECT_EQ(eeprom.writeCalls, 2);
+    EXPECT_EQ(eeprom.pagePrograms, 2);
+    EXPECT_EQ(journal.getJournalLength(), 5);
+
+    EXPECT_EQ(loadOther(), settingsContainer);
+}
+
+TEST_F(SettingsJournalTest, compaction)
+{
+    ASSERT_FALSE(journal.loadSettings());
+
+    for (size_t i = 0; i < Journal::Capacity; ++i)
+    {
+        ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_min + i));
+        journal.saveSettings();
+    }
+    EXPECT_EQ(journal.getJournalLength(), Journal::Capacity);
+    EXPECT_EQ(journal.getGeneration(), 1);
+    EXPECT_EQ(loadOther(), settingsContainer);
+
+    // full journal, the next change goes to a new snapshot in the other slot followed by the
+    // marker of the new journal, where the full one ended
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    eeprom.resetCounters();
+    journal.saveSettings();
+    EXPECT_EQ(journal.getJournalLength(), 0);
+    EXPECT_EQ(journal.getGeneration(), 2);
+    EXPECT_EQ(journal.getJournalStart(), 0);
+    EXPECT_EQ(eeprom.lastWriteAddress, Journal::getRecordOffset(0));
+    EXPECT_EQ(eeprom.lastWriteLength, sizeof(Journal::Record));
+
+    // old records are ignored
+    EXPECT_EQ(loadOther(), settingsContainer);
+
+    // and overwritten
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    journal.saveSettings();
+    EXPECT_EQ(eeprom.lastWriteAddress, Journal::getRecordOffset(1));
+    EXPECT_EQ(loadOther(), settingsContainer);
+}
+
+TEST_F(SettingsJournalTest, compactionWithUnchangedValues)
+{
+    ASSERT_FALSE(journal.loadSettings());
+
+    // values changed and changed back until the journal is full
+    for (size_t i = 0; i < Journal::Capacity; ++i)
+    {
+        ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(
+            i % 2 == 0 ? TestSettings::Entry3_max : TestSettings::Entry3_default));
+        journal.saveSettings();
+    }
+    ASSERT_EQ(journal.getJournalLength(), Journal::Capacity);
+
+    // the snapshot holds the values already, a new generation is written anyway
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_default));
+    journal.saveSettings();
+    EXPECT_EQ(journal.getGeneration(), 2);
+    EXPECT_EQ(loadOther(), settingsContainer);
+
+    // records appended to it are loaded
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    journal.saveSettings();
+    EXPECT_EQ(journal.getJournalLength(), 1);
+    EXPECT_EQ(loadOther(), settingsContainer);
+}
+
+TEST_F(SettingsJournalTest, ringContinuesAfterCompaction)
+{
+    ASSERT_FALSE(journal.loadSettings());
+    for (size_t i = 0; i < Journal::Capacity - 2; ++i)
+    {
+        ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_min + i));
+        journal.saveSettings();
+    }
+
+    // too many changes for the journal, the next one starts behind the last record
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_max));
+    journal.saveSettings();
+    EXPECT_EQ(journal.getGeneration(), 2);
+    EXPECT_EQ(journal.getJournalStart(), Journal::Capacity - 1);
+    EXPECT_EQ(loadOther(), settingsContainer);
+
+    // records wrap around to the first page
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_min));
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_min));
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_min));
+    eeprom.resetCounters();
+    journal.saveSettings();
+    EXPECT_EQ(eeprom.writeCalls, 2);
+    EXPECT_EQ(eeprom.lastWriteAddress, Journal::getRecordOffset(0));
+    EXPECT_EQ(journal.getJournalLength(), 3);
+
+    Container otherContainer;
+    Journal otherJournal{eeprom, otherContainer, scratch};
+    EXPECT_TRUE(otherJournal.loadSettings());
+    EXPECT_EQ(otherContainer, settingsContainer);
+    EXPECT_EQ(otherJournal.getJournalStart(), Journal::Capacity - 1);
+    EXPECT_EQ(otherJournal.getJournalLength(), 3);
+}
+
+TEST_F(SettingsJournalTest, tornRecord)
+{
+    ASSERT_FALSE(journal.loadSettings());
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    journal.saveSettings();
+    const Container SavedContainer = settingsContainer;
+
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_min));
+    journal.saveSettings();
+    auto record = readRecord(2);
+    record.value = TestSettings::Entry1_min + 1;
+    writeRecord(2, record);
+
+    // journal ends before the torn record
+    Container otherContainer;
+    Journal otherJournal{eeprom, otherContainer, scratch};
+    EXPECT_TRUE(otherJournal.loadSettings());
+    EXPECT_EQ(otherContainer, SavedContainer);
+    EXPECT_EQ(otherJournal.getJournalLength(), 1);
+
+    // the torn record gets overwritten
+    ASSERT_TRUE(otherContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    otherJournal.saveSettings();
+    EXPECT_EQ(eeprom.lastWriteAddress, Journal::getRecordOffset(2));
+    EXPECT_EQ(loadOther(), otherContainer);
+}
+
+TEST_F(SettingsJournalTest, recordOfOtherPosition)
+{
+    ASSERT_FALSE(journal.loadSettings());
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    journal.saveSettings();
+
+    // a valid record copied to another position is rejected
+    writeRecord(2, readRecord(1));
+    Container otherContainer;
+    Journal otherJournal{eeprom, otherContainer, scratch};
+    EXPECT_TRUE(otherJournal.loadSettings());
+    EXPECT_EQ(otherJournal.getJournalLength(), 1);
+}
+
+TEST_F(SettingsJournalTest, recordCheck)
+{
+    Journal::Record record;
+    record.index = 3;
+    record.value = 0x12345678;
+    const uint16_t Check = Journal::checkRecord(7, 5, record);
+
+    // bound to the generation and position
+    EXPECT_NE(Journal::checkRecord(8, 5, record), Check);
+    EXPECT_NE(Journal::checkRecord(7, 6, record), Check);
+
+    // CRC-16 catches every single bit flip of index and value
+    for (size_t bit = 0; bit < 32; ++bit)
+    {
+        Journal::Record flipped = record;
+        flipped.value ^= 1U << bit;
+        EXPECT_NE(Journal::checkRecord(7, 5, flipped), Check) << bit;
+        flipped = record;
+        flipped.index ^= static_cast<uint16_t>(1U << (bit % 16));
+        EXPECT_NE(Journal::checkRecord(7, 5, flipped), Check) << bit;
+    }
+}
+
+TEST_F(SettingsJournalTest, interruptedCompaction)
+{
+    ASSERT_FALSE(journal.loadSettings());
+    for (size_t i = 0; i < Journal::Capacity; ++i)
+    {
+        ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_min + i));
+        journal.saveSettings();
+    }
+    const Container SavedContainer = settingsContainer;
+    const auto Marker = readRecord(0);
+
+    // power loss while writing the new snapshot, before the marker of its journal
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    journal.saveSettings();
+    const size_t ValueOffset =
+        Journal::SnapshotIO::getSlotOffset(1) + Journal::SnapshotIO::HeaderSize;
+    uint8_t value = 0;
+    eeprom.read(ValueOffset, &value, 1);
+    value ^= 0x55;
+    eeprom.write(ValueOffset, &value, 1);
+    writeRecord(0, Marker);
+
+    // older snapshot and its journal are still intact
+    EXPECT_EQ(loadOther(), SavedContainer);
+}
+
+TEST_F(SettingsJournalTest, missingMarker)
+{
+    ASSERT_FALSE(journal.loadSettings());
+    for (size_t i = 0; i < Journal::Capacity - 1; ++i)
+    {
+        ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_min + i));
+        journal.saveSettings();
+    }
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    journal.saveSettings();
+    ASSERT_EQ(journal.getGeneration(), 2);
+    ASSERT_EQ(journal.getJournalStart(), Journal::Capacity);
+
+    // power loss after the snapshot, before its marker: the journal is empty and starts over at
+    // the first record, the load writes the marker there
+    writeRecord(Journal::Capacity, Journal::Record{});
+    Container otherContainer;
+    Journal otherJournal{eeprom, otherContainer, scratch};
+    eeprom.resetCounters();
+    EXPECT_TRUE(otherJournal.loadSettings());
+    EXPECT_EQ(otherContainer, settingsContainer);
+    EXPECT_EQ(otherJournal.getJournalStart(), 0);
+    EXPECT_EQ(otherJournal.getJournalLength(), 0);
+    EXPECT_EQ(eeprom.writeCalls, 1);
+    EXPECT_EQ(readRecord(0).index, Journal::MarkerIndex);
+
+    ASSERT_TRUE(otherContainer.setValue<TestSettings::Entry3>(TestSettings::Entry3_max));
+    otherJournal.saveSettings();
+    EXPECT_EQ(eeprom.lastWriteAddress, Journal::getRecordOffset(1));
+    EXPECT_EQ(loadOther(), otherContainer);
+}
+
+TEST_F(SettingsJournalTest, saveBeforeLoad)
+{
+    ASSERT_FALSE(journal.loadSettings());
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    journal.saveSettings();
+
+    // persisted state is read first, the change gets appended
+    Container otherContainer;
+    Journal otherJournal{eeprom, otherContainer, scratch};
+    ASSERT_TRUE(otherContainer.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    otherJournal.saveChangedSettings();
+    EXPECT_EQ(otherJournal.getJournalLength(), 2);
+
+    const Container Loaded = loadOther();
+    EXPECT_FLOAT_EQ(Loaded.getValue<TestSettings::Entry1>(), TestSettings::Entry1_max);
+    EXPECT_FLOAT_EQ(Loaded.getValue<TestSettings::Entry2>(), TestSettings::Entry2_max);
+}
+
+TEST_F(SettingsJournalTest, outOfBoundsRecord)
+{
+    ASSERT_FALSE(journal.loadSettings());
+    Journal::Record record;
+    record.index = Container::getIndex<TestSettings::Entry1>();
+    record.value = Container::Layout::toRaw(record.index, TestSettings::Entry1_max + 1);
+    record.check = Journal::checkRecord(journal.getGeneration(), 1, record);
+    writeRecord(1, record);
+
+    // replaced by default and written back
+    EXPECT_EQ(loadOther(), Container{});
+    Container otherContainer;
+    Journal otherJournal{eeprom, otherContainer, scratch};
+    EXPECT_TRUE(otherJournal.loadSettings());
+    EXPECT_EQ(otherJournal.getJournalLength(), 2);
+}
+
+TEST_F(SettingsJournalTest, statistics)
+{
+    using StatisticsJournal =
+        SettingsJournal<TestSettings::EntryArray.size(), TestSettings::EntryArray,
+                        CountingFakeEeprom, 2, FnvIntegrity, IoStatistics<FakeClock>>;
+    StatisticsJournal::ImageBuffer statisticsScratch{};
+    StatisticsJournal statisticsJournal{eeprom, settingsContainer, statisticsScratch};
+
+    EXPECT_FALSE(statisticsJournal.loadSettings());
+    const auto &Statistics = statisticsJournal.getStatistics();
+    EXPECT_EQ(Statistics.loadCount, 1);
+    EXPECT_EQ(Statistics.signatureFailures, 1);
+    // the write back of the defaults isn't a save, its marker is a page program of the journal
+    EXPECT_EQ(Statistics.saveCount, 0);
+    EXPECT_EQ(Statistics.pagePrograms, 1);
+    EXPECT_EQ(Statistics.bytesWritten, sizeof(StatisticsJournal::Record));
+    EXPECT_EQ(statisticsJournal.getSnapshotStatistics().saveCount, 1);
+
+    ASSERT_TRUE(settingsContainer.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    eeprom.resetCounters();
+    statisticsJournal.saveSettings();
+    EXPECT_EQ(Statistics.saveCount, 1);
+    EXPECT_EQ(Statistics.pagePrograms, 2);
+    EXPECT_EQ(Statistics.bytesWritten, 2 * sizeof(StatisticsJournal::Record));
+    EXPECT_EQ(eeprom.pagePrograms, 1);
+
+    // the page holding the marker and the records is read once
+    Container otherContainer;
+    StatisticsJournal otherJournal{eeprom, otherContainer, statisticsScratch};
+    EXPECT_TRUE(otherJournal.loadSettings());
+    EXPECT_EQ(otherJournal.getStatistics().loadCount, 1);
+    EXPECT_EQ(otherJournal.getStatistics().bytesRead, CountingFakeEeprom::getPageSize());
+    EXPECT_GT(otherJournal.getSnapshotStatistics().bytesRead, 0);
+    EXPECT_EQ(otherJournal.getSnapshotStatistics().pagePrograms, 0);
+}
+} // namespace
@@ -0,0 +1,161 @@
+#include "TestSettings.hpp"
+#include "settings-manager/SettingsText.hpp"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <string>
+
+using namespace settings;
+using namespace TestSettings;
+
+namespace
+{
+using Text = SettingsText<EntryArray.size(), EntryArray>;
+
+class SettingsTextTest : public ::testing::Test
+{
+protected:
+    Container settingsContainer;
+};
+
+TEST_F(SettingsTextTest, appendText)
+{
+    ASSERT_TRUE(settingsContainer.setValue<Entry2>(20.5f));
+    std::string text = "# dump\n";
+    Text::appendText(settingsContainer, text);
+    EXPECT_EQ(text, "# dump\n"
+                    "entry1=10\n"
+                    "entry2=20.5\n"
+                    "entry3=30\n"
+                    "entryBoolean=true\n"
+                    "entryInteger=66\n");
+}
+
+TEST_F(SettingsTextTest, appendJson)
+{
+    ASSERT_TRUE(settingsContainer.setValue<EntryBoolean>(false));
+    ASSERT_TRUE(settingsContainer.setValue<Entry1>(0.1f + 1));
+    std::string text;
+    Text::appendJson(settingsContainer, text);
+    EXPECT_EQ(text, "{\n"
+                    "  \"entry1\": 1.1,\n"
+                    "  \"entry2\": 20,\n"
+                    "  \"entry3\": 30,\n"
+                    "  \"entryBoolean\": false,\n"
+                    "  \"entryInteger\": 66\n"
+                    "}");
+}
+
+TEST_F(SettingsTextTest, nonFiniteRealsInJson)
+{
+    // values as saved, not limited by bounds
+    Container::ValueArray values;
+    settingsContainer.copyValuesTo(values);
+    Container::Layout::setRaw(
+        values, Container::getIndex<Entry1>(),
+        __builtin_bit_cast(Container::Raw_t, -std::numeric_limits<float>::infinity()));
+    Container::Layout::setRaw(
+        values, Container::getIndex<Entry2>(),
+        __builtin_bit_cast(Container::Raw_t, std::numeric_limits<float>::quiet_NaN()));
+    std::string text;
+    Text::appendJson(values, text);
+    EXPECT_EQ(text.substr(0, 56), "{\n"
+                                  "  \"entry1\": \"-inf\",\n"
+                                  "  \"entry2\": \"nan\",\n"
+                                  "  \"entry3\": 30,");
+}
+
+TEST_F(SettingsTextTest, readText)
+{
+    const auto Result = Text::readText("# comment\n"
+                                       "\n"
+                                       "entry1=42.25\n"
+                                       "  entry3 =\t3 \r\n"
+                                       "entryBoolean=false\n"
+                                       "entryInteger=65534",
+                                       settingsContainer);
+    EXPECT_TRUE(Result.isValid());
+    EXPECT_EQ(Result.lineCount, 6);
+    EXPECT_EQ(Result.assignedCount, 4);
+    EXPECT_EQ(Result.firstErrorLine, 0);
+
+    EXPECT_EQ(settingsContainer.getValue<Entry1>(), 42.25f);
+    EXPECT_EQ(settingsContainer.getValue<Entry2>(), Entry2_default);
+    EXPECT_EQ(settingsContainer.getValue<Entry3>(), 3);
+    EXPECT_FALSE((settingsContainer.getValue<EntryBoolean, bool>()));
+    EXPECT_EQ((settingsContainer.getValue<EntryInteger, int32_t>()), 0xFFFE);
+    EXPECT_TRUE(settingsContainer.hasDirtyEntries());
+}
+
+TEST_F(SettingsTextTest, numericFormsOfTypes)
+{
+    EXPECT_TRUE(Text::readText("entryBoolean=0\nentryInteger=-0\nentry1=1e1", settingsContainer)
+                    .isValid());
+    EXPECT_FALSE((settingsContainer.getValue<EntryBoolean, bool>()));
+    EXPECT_EQ((settingsContainer.getValue<EntryInteger, int32_t>()), 0);
+    EXPECT_EQ(settingsContainer.getValue<Entry1>(), 10);
+
+    // integers are whole decimal numbers
+    const auto Result =
+        Text::readText("entryInteger=1.5\nentryInteger=2.0\nentryInteger=1e2", settingsContainer);
+    EXPECT_EQ(Result.invalidValueCount, 3);
+    EXPECT_EQ(Result.firstErrorLine, 1);
+    EXPECT_EQ((settingsContainer.getValue<EntryInteger, int32_t>()), 0);
+}
+
+TEST_F(SettingsTextTest, appendEscaped)
+{
+    std::string text;
+    Text::appendEscaped("a\"b\\c\nd\te\rf\x01\x1F\x7F", text);
+    EXPECT_EQ(text, "a\\\"b\\\\c\\nd\\te\\rf\\u0001\\u001f\x7F");
+}
+
+TEST_F(SettingsTextTest, rejectsLines)
+{
+    const auto Result = Text::readText("entry1=50\n"
+                                       "unknown=1\n"
+                                       "entry2=1000\n"
+                                       "entry3\n"
+                                       "entryInteger=x\n"
+                                       "entryBoolean=yes\n"
+                                       "entry3=nan\n"
+                                       "entry2=\n"
+                                       "entry2=25",
+                                       settingsContainer);
+    EXPECT_FALSE(Result.isValid());
+    EXPECT_EQ(Result.unknownNameCount, 2);
+    EXPECT_EQ(Result.invalidValueCount, 5);
+    EXPECT_EQ(Result.firstErrorLine, 2);
+    EXPECT_EQ(Result.assignedCount, 2);
+
+    // valid lines are still assigned
+    EXPECT_EQ(settingsContainer.getValue<Entry1>(), 50);
+    EXPECT_EQ(settingsContainer.getValue<Entry2>(), 25);
+    EXPECT_EQ(settingsContainer.getValue<Entry3>(), Entry3_default);
+}
+
+TEST_F(SettingsTextTest, roundTrip)
+{
+    ASSERT_TRUE(settingsContainer.setValue<Entry1>(1 + 1.0f / 3));
+    ASSERT_TRUE(settingsContainer.setValue<Entry3>(299.99997f));
+    ASSERT_TRUE(settingsContainer.setValue<EntryInteger>(12345));
+    ASSERT_TRUE(settingsContainer.setValue<EntryBoolean>(false));
+    std::string text;
+    Text::appendText(settingsContainer, text);
+
+    Container other;
+    const auto Result = Text::readText(text, other);
+    EXPECT_TRUE(Result.isValid());
+    EXPECT_EQ(Result.assignedCount, EntryArray.size());
+    EXPECT_EQ(other, settingsContainer);
+}
+
+TEST_F(SettingsTextTest, singleLookupPerLine)
+{
+    const size_t LookupsBefore = TestSettings::NameLookups::lookupCount;
+    EXPECT_TRUE(Text::readText("entry1=2\nentry2=3\n", settingsContainer).isValid());
+    // NameIndex directly, not the asserting getIndex()
+    EXPECT_EQ(TestSettings::NameLookups::lookupCount, LookupsBefore);
+}
+} // namespace
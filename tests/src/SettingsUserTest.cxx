@@ -6,6 +6,10 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace
 {
 using namespace settings;
@@ -52,4 +56,319 @@ TEST_F(SettingsUserTest, notifySettings)
     EXPECT_TRUE(settingsUpdateFunctionCalled);
     EXPECT_FLOAT_EQ(value, 20.0f);
 }
-} // namespace
\ No newline at end of file
+
+class Subscriber : public SettingsSubscriber<TestSettings::Container, TestSettings::Entry1,
+                                             TestSettings::EntryInteger>
+{
+public:
+    void onSettingsUpdate() override
+    {
+        updateCount++;
+    }
+
+    size_t updateCount = 0;
+};
+
+class OtherSubscriber : public SettingsSubscriber<TestSettings::Container, TestSettings::Entry3>
+{
+public:
+    void onSettingsUpdate() override
+    {
+        updateCount++;
+    }
+
+    size_t updateCount = 0;
+};
+
+TEST_F(SettingsUserTest, dependencyMask)
+{
+    constexpr auto Mask = Subscriber::getDependencyMask();
+    static_assert(Mask.size() == 1);
+    using TestSettings::Container;
+    static_assert(Mask[0] == ((1 << Container::getIndex<TestSettings::Entry1>()) |
+                              (1 << Container::getIndex<TestSettings::EntryInteger>())));
+}
+
+// 39 booleans pack into two value words, but need two mask words of one bit per setting
+constexpr size_t BooleanCount = 39;
+
+constexpr std::array<char, 2 * BooleanCount> createBooleanNames()
+{
+    std::array<char, 2 * BooleanCount> names{};
+    for (size_t i = 0; i < BooleanCount; ++i)
+    {
+        names[2 * i] = 'b';
+        names[2 * i + 1] = static_cast<char>('0' + i);
+    }
+    return names;
+}
+constexpr std::array<char, 2 * BooleanCount> BooleanNames = createBooleanNames();
+constexpr std::string_view Real = "real";
+
+template <size_t... Indices>
+constexpr std::array<SettingsEntry, BooleanCount + 1>
+createMostlyBooleanEntries(std::index_sequence<Indices...>)
+{
+    return {SettingsEntry{0.0f, 1.0f, 2.0f, Real},
+            SettingsEntry{false, std::string_view{BooleanNames.data() + 2 * Indices, 2}}...};
+}
+constexpr std::array MostlyBooleanEntries =
+    createMostlyBooleanEntries(std::make_index_sequence<BooleanCount>{});
+using MostlyBooleanContainer =
+    SettingsContainer<MostlyBooleanEntries.size(), MostlyBooleanEntries>;
+constexpr std::string_view LastBoolean{BooleanNames.data() + 2 * (BooleanCount - 1), 2};
+
+class LastBooleanSubscriber : public SettingsSubscriber<MostlyBooleanContainer, LastBoolean>
+{
+public:
+    void onSettingsUpdate() override
+    {
+        updateCount++;
+    }
+
+    size_t updateCount = 0;
+};
+
+TEST(SettingsSubscriberTest, mostlyBooleans)
+{
+    static_assert(std::tuple_size_v<MostlyBooleanContainer::ValueArray> == 3);
+    constexpr auto Mask = LastBooleanSubscriber::getDependencyMask();
+    static_assert(Mask.size() == 2);
+    static_assert(Mask[1] == 1UL << (BooleanCount % SettingsChanges::BitsPerWord));
+
+    MostlyBooleanContainer container;
+    LastBooleanSubscriber subscriber;
+    ASSERT_TRUE(container.setValue<LastBoolean>(true));
+    container.notifySettingsUsers();
+    EXPECT_EQ(subscriber.updateCount, 1);
+}
+
+TEST(SettingsSubscriberTest, otherContainer)
+{
+    // index 0 of another settings table is not Entry1
+    static_assert(TestSettings::Container::getIndex<TestSettings::Entry1>() == 0);
+    Subscriber subscriber;
+    MostlyBooleanContainer other;
+    ASSERT_TRUE(other.setValue<Real>(2.0f));
+    other.notifySettingsUsers();
+    EXPECT_EQ(subscriber.updateCount, 0);
+
+    TestSettings::Container container;
+    ASSERT_TRUE(container.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    container.notifySettingsUsers();
+    EXPECT_EQ(subscriber.updateCount, 1);
+}
+
+TEST_F(SettingsUserTest, notifyAffectedUsersOnly)
+{
+    auto &container = settingsIoTest.settingsContainer;
+    Subscriber subscriber;
+    OtherSubscriber otherSubscriber;
+
+    // nothing changed since load
+    container.notifySettingsUsers();
+    EXPECT_FALSE(settingsUpdateFunctionCalled);
+
+    ASSERT_TRUE(container.setValue<TestSettings::EntryInteger>(1));
+    container.notifySettingsUsers();
+    EXPECT_EQ(subscriber.updateCount, 1);
+    EXPECT_EQ(otherSubscriber.updateCount, 0);
+    // plain users are affected by everything
+    EXPECT_TRUE(settingsUpdateFunctionCalled);
+
+    // same value is no change
+    ASSERT_TRUE(container.setValue<TestSettings::EntryInteger>(1));
+    container.notifySettingsUsers();
+    EXPECT_EQ(subscriber.updateCount, 1);
+
+    ASSERT_TRUE(container.setValue<TestSettings::Entry3>(TestSettings::Entry3_max));
+    ASSERT_TRUE(container.setValue<TestSettings::Entry2>(TestSettings::Entry2_max));
+    EXPECT_TRUE(container.getUnnotifiedEntries().test(
+        TestSettings::Container::getIndex<TestSettings::Entry2>()));
+    container.notifySettingsUsers();
+    EXPECT_EQ(subscriber.updateCount, 1);
+    EXPECT_EQ(otherSubscriber.updateCount, 1);
+    EXPECT_FALSE(container.getUnnotifiedEntries().any());
+
+    // saving doesn't swallow notifications
+    ASSERT_TRUE(container.setValue<TestSettings::Entry1>(TestSettings::Entry1_max));
+    settingsIoTest.settingsIo.saveChangedSettings();
+    container.notifySettingsUsers();
+    EXPECT_EQ(subscriber.updateCount, 2);
+
+    // broadcast still reaches everyone
+    SettingsUser::notifySettingsUpdate();
+    EXPECT_EQ(subscriber.updateCount, 3);
+    EXPECT_EQ(otherSubscriber.updateCount, 2);
+}
+
+TEST_F(SettingsUserTest, batchUpdate)
+{
+    auto &container = settingsIoTest.settingsContainer;
+    auto &eeprom = settingsIoTest.eeprom;
+    Subscriber subscriber;
+    OtherSubscriber otherSubscriber;
+
+    const std::array Profile = {
+        IndexedValue{container.getIndex(TestSettings::Entry1), TestSettings::Entry1_max},
+        IndexedValue{container.getIndex(TestSettings::EntryInteger), 7},
+        IndexedValue{container.getIndex(TestSettings::Entry2), TestSettings::Entry2_max},
+    };
+    ASSERT_TRUE(container.setValues(Profile));
+
+    // one notification for the whole batch, the users of changed settings only
+    container.notifySettingsUsers();
+    EXPECT_EQ(subscriber.updateCount, 1);
+    EXPECT_EQ(otherSubscriber.updateCount, 0);
+
+    // one save for the whole batch
+    settingsIoTest.settingsIo.saveChangedSettings();
+    EXPECT_FALSE(container.hasDirtyEntries());
+    TestSettings::Container reloaded;
+    TestSettings::IO otherIo{eeprom, reloaded};
+    EXPECT_TRUE(otherIo.loadSettings());
+    EXPECT_EQ(reloaded, container);
+}
+} // namespace
+namespace
+{
+class CountingUser : public settings::SettingsUser
+{
+public:
+    void onSettingsUpdate() override
+    {
+        updateCount++;
+    }
+
+    size_t updateCount = 0;
+};
+
+TEST(SettingsUserRegistry, manyInstances)
+{
+    const size_t InitialCount = SettingsUser::getRegisteredInstanceCount();
+    std::vector<CountingUser> users(100);
+    EXPECT_EQ(SettingsUser::getRegisteredInstanceCount(), InitialCount + 100);
+
+    SettingsUser::notifySettingsUpdate();
+    for (const auto &user : users)
+    {
+        EXPECT_EQ(user.updateCount, 1);
+    }
+
+    // removing from the middle, the front and the back keeps the others registered
+    users.erase(users.begin() + 50);
+    users.erase(users.begin());
+    users.pop_back();
+    EXPECT_EQ(SettingsUser::getRegisteredInstanceCount(), InitialCount + 97);
+    SettingsUser::notifySettingsUpdate();
+    for (const auto &user : users)
+    {
+        EXPECT_EQ(user.updateCount, 2);
+    }
+
+    users.clear();
+    EXPECT_EQ(SettingsUser::getRegisteredInstanceCount(), InitialCount);
+    SettingsUser::notifySettingsUpdate();
+}
+
+TEST(SettingsUserRegistry, copies)
+{
+    const size_t InitialCount = SettingsUser::getRegisteredInstanceCount();
+    CountingUser user;
+    {
+        CountingUser copy = user;
+        copy = user;
+        EXPECT_EQ(SettingsUser::getRegisteredInstanceCount(), InitialCount + 2);
+        SettingsUser::notifySettingsUpdate();
+        EXPECT_EQ(copy.updateCount, 1);
+    }
+    EXPECT_EQ(SettingsUser::getRegisteredInstanceCount(), InitialCount + 1);
+    SettingsUser::notifySettingsUpdate();
+    EXPECT_EQ(user.updateCount, 2);
+}
+
+class SelfRemovingUser : public settings::SettingsUser
+{
+public:
+    explicit SelfRemovingUser(std::unique_ptr<SelfRemovingUser> &owner) : owner(owner)
+    {
+    }
+
+    void onSettingsUpdate() override
+    {
+        owner.reset();
+    }
+
+private:
+    std::unique_ptr<SelfRemovingUser> &owner;
+};
+
+TEST(SettingsUserRegistry, removeWhileNotifying)
+{
+    CountingUser before;
+    std::unique_ptr<SelfRemovingUser> selfRemoving;
+    selfRemoving = std::make_unique<SelfRemovingUser>(selfRemoving);
+    CountingUser after;
+
+    SettingsUser::notifySettingsUpdate();
+    EXPECT_EQ(selfRemoving, nullptr);
+    EXPECT_EQ(before.updateCount, 1);
+    EXPECT_EQ(after.updateCount, 1);
+}
+
+/// Destroys another user, optionally notifying again first.
+class RemovingUser : public settings::SettingsUser
+{
+public:
+    RemovingUser(std::unique_ptr<CountingUser> &other, bool notifiesAgain)
+        : other(other), notifiesAgain(notifiesAgain)
+    {
+    }
+
+    void onSettingsUpdate() override
+    {
+        updateCount++;
+        if (notifiesAgain && updateCount == 1)
+        {
+            SettingsUser::notifySettingsUpdate();
+        }
+        other.reset();
+    }
+
+    size_t updateCount = 0;
+
+private:
+    std::unique_ptr<CountingUser> &other;
+    bool notifiesAgain;
+};
+
+TEST(SettingsUserRegistry, removeNextWhileNotifying)
+{
+    const size_t InitialCount = SettingsUser::getRegisteredInstanceCount();
+    std::unique_ptr<CountingUser> next;
+    RemovingUser removing{next, false};
+    next = std::make_unique<CountingUser>();
+    CountingUser after;
+
+    // next is destroyed before its turn, the notification goes on with the one after it
+    SettingsUser::notifySettingsUpdate();
+    EXPECT_EQ(next, nullptr);
+    EXPECT_EQ(removing.updateCount, 1);
+    EXPECT_EQ(after.updateCount, 1);
+    EXPECT_EQ(SettingsUser::getRegisteredInstanceCount(), InitialCount + 2);
+}
+
+TEST(SettingsUserRegistry, removeWhileNotifyingAgain)
+{
+    std::unique_ptr<CountingUser> next;
+    RemovingUser removing{next, true};
+    next = std::make_unique<CountingUser>();
+    CountingUser after;
+
+    // next is destroyed by the inner notification, both skip it
+    SettingsUser::notifySettingsUpdate();
+    EXPECT_EQ(next, nullptr);
+    EXPECT_EQ(removing.updateCount, 2);
+    EXPECT_EQ(after.updateCount, 2);
+}
+} // namespace
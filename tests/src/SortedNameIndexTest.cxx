@@ -0,0 +1,118 @@
+#include "GeneratedSettings.hpp"
+#include "settings-manager/SettingsContainer.hpp"
+#include "settings-manager/SortedNameIndex.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string_view>
+#include <vector>
+
+using namespace settings;
+
+namespace
+{
+constexpr std::string_view MotorKp = "motor.pid.kp";
+constexpr std::string_view MotorKi = "motor.pid.ki";
+constexpr std::string_view MotorMaxCurrent = "motor.maxCurrent";
+constexpr std::string_view Motorcycle = "motorcycle.speed";
+constexpr std::string_view BatteryCells = "battery.cells";
+constexpr std::string_view BatteryCapacity = "battery.capacity";
+constexpr std::string_view Motor = "motor";
+
+constexpr std::array HierarchicalEntryArray = {
+    SettingsEntry{0, 1, 10, MotorKp},          SettingsEntry{0, 1, 10, MotorKi},
+    SettingsEntry{0, 1, 10, BatteryCells},     SettingsEntry{0, 1, 10, MotorMaxCurrent},
+    SettingsEntry{0, 1, 10, Motorcycle},       SettingsEntry{0, 1, 10, BatteryCapacity},
+    SettingsEntry{0, 1, 10, Motor},
+};
+using Container = SettingsContainer<HierarchicalEntryArray.size(), HierarchicalEntryArray>;
+using Sorted = Container::SortedNames;
+
+constexpr size_t GeneratedCount = 2048;
+using GeneratedSorted =
+    SortedNameIndex<GeneratedCount, GeneratedSettings::EntryArray<GeneratedCount>>;
+
+std::vector<std::string_view> namesWithPrefix(std::string_view prefix)
+{
+    std::vector<std::string_view> names;
+    Sorted::forEachWithPrefix(
+        prefix, [&names](size_t index) { names.push_back(HierarchicalEntryArray[index].name); });
+    return names;
+}
+
+TEST(SortedNameIndexTest, sortedOrder)
+{
+    for (size_t position = 1; position < HierarchicalEntryArray.size(); ++position)
+    {
+        EXPECT_LT(HierarchicalEntryArray[Sorted::getIndexAt(position - 1)].name,
+                  HierarchicalEntryArray[Sorted::getIndexAt(position)].name);
+    }
+    using GeneratedNames = GeneratedSettings::Names<GeneratedCount>;
+    for (size_t position = 1; position < GeneratedCount; ++position)
+    {
+        EXPECT_LT(GeneratedNames::get(GeneratedSorted::getIndexAt(position - 1)),
+                  GeneratedNames::get(GeneratedSorted::getIndexAt(position)));
+    }
+}
+
+TEST(SortedNameIndexTest, find)
+{
+    for (size_t i = 0; i < HierarchicalEntryArray.size(); ++i)
+    {
+        const auto [exists, index] = Sorted::find(HierarchicalEntryArray[i].name);
+        EXPECT_TRUE(exists);
+        EXPECT_EQ(index, i);
+    }
+    for (size_t i = 0; i < GeneratedCount; ++i)
+    {
+        const auto [exists, index] =
+            GeneratedSorted::find(GeneratedSettings::Names<GeneratedCount>::get(i));
+        EXPECT_TRUE(exists);
+        EXPECT_EQ(index, i);
+    }
+    for (const std::string_view name : {"", "motor.", "motor.pid", "zzz", "a", "motor.pid.kpx"})
+    {
+        EXPECT_FALSE(std::get<0>(Sorted::find(name))) << name;
+    }
+    static_assert(std::get<1>(Sorted::find(MotorMaxCurrent)) == 3);
+}
+
+TEST(SortedNameIndexTest, lowerBound)
+{
+    EXPECT_EQ(Sorted::lowerBound(""), 0);
+    EXPECT_EQ(Sorted::getIndexAt(Sorted::lowerBound("")), 5); // battery.capacity
+    EXPECT_EQ(Sorted::getIndexAt(Sorted::lowerBound("battery.d")), 6); // motor
+    EXPECT_EQ(Sorted::getIndexAt(Sorted::lowerBound(MotorKi)), 1);
+    EXPECT_EQ(Sorted::lowerBound("zzz"), HierarchicalEntryArray.size());
+}
+
+TEST(SortedNameIndexTest, forEachWithPrefix)
+{
+    EXPECT_EQ(namesWithPrefix("motor."),
+              (std::vector<std::string_view>{MotorMaxCurrent, MotorKi, MotorKp}));
+    EXPECT_EQ(namesWithPrefix("motor.pid."), (std::vector<std::string_view>{MotorKi, MotorKp}));
+    EXPECT_EQ(namesWithPrefix("battery."),
+              (std::vector<std::string_view>{BatteryCapacity, BatteryCells}));
+    EXPECT_EQ(namesWithPrefix("motor").size(), 5);
+    EXPECT_EQ(namesWithPrefix("").size(), HierarchicalEntryArray.size());
+    EXPECT_TRUE(namesWithPrefix("servo.").empty());
+    EXPECT_TRUE(namesWithPrefix("motor.pid.kp.").empty());
+
+    static_assert(Sorted::countWithPrefix("motor.") == 3);
+    EXPECT_EQ(GeneratedSorted::countWithPrefix("setting00"), 100);
+}
+
+TEST(SortedNameIndexTest, container)
+{
+    Container settings;
+    size_t count = 0;
+    settings.forEachWithPrefix("motor.pid.", [&](size_t index) {
+        EXPECT_TRUE(settings.setValue(index, 5));
+        ++count;
+    });
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(settings.getValue<MotorKp>(), 5);
+    EXPECT_EQ(settings.getValue<MotorKi>(), 5);
+    EXPECT_EQ(settings.getValue<MotorMaxCurrent>(), 1);
+}
+} // namespace
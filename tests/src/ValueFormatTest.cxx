@@ -0,0 +1,190 @@
+#include "fake/CountingFakeEeprom.hpp"
+#include "settings-manager/SettingsContainer.hpp"
+#include "settings-manager/SettingsIO.hpp"
+#include "settings-manager/ValueFormat.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace settings;
+
+namespace
+{
+constexpr std::string_view Enabled = "enabled";
+constexpr std::string_view Address = "address";
+constexpr std::string_view Trim = "trim";
+constexpr std::string_view Gain = "gain";
+constexpr std::string_view Fixed = "fixed";
+
+constexpr std::array EntryArray = {
+    SettingsEntry{false, Enabled},
+    SettingsEntry{0, 0x42, 0xFFFF, Address, VariableType::integerType},
+    SettingsEntry{-5, 0, 9, Trim, VariableType::integerType},
+    SettingsEntry{-2.0f, 1.0f, 2.0f, Gain},
+    SettingsEntry{7, 7, 7, Fixed, VariableType::integerType},
+};
+using Container = SettingsContainer<EntryArray.size(), EntryArray>;
+using Serializer = CompactFormat::Serializer<EntryArray.size(), EntryArray>;
+using NativeIO = SettingsIO<EntryArray.size(), EntryArray, CountingFakeEeprom>;
+using CompactIO =
+    SettingsIO<EntryArray.size(), EntryArray, CountingFakeEeprom, 1, FnvIntegrity, CompactFormat>;
+
+TEST(ValueFormat, compactSize)
+{
+    static_assert(Serializer::getBitWidth(Container::getIndex<Enabled>()) == 1);
+    static_assert(Serializer::getBitWidth(Container::getIndex<Address>()) == 16);
+    static_assert(Serializer::getBitWidth(Container::getIndex<Trim>()) == 4);
+    static_assert(Serializer::getBitWidth(Container::getIndex<Gain>()) == 32);
+    static_assert(Serializer::getBitWidth(Container::getIndex<Fixed>()) == 0);
+    static_assert(Serializer::getSerializedSize() == 7);
+
+    static_assert(NativeFormat::Serializer<EntryArray.size(), EntryArray>::getSerializedSize() ==
+                  sizeof(Container::ValueArray));
+    // saves rewrite header and values, the larger table is written once
+    static_assert(sizeof(CompactIO::ContentHead) < sizeof(NativeIO::ContentHead));
+}
+
+TEST(ValueFormat, compactLayout)
+{
+    Container container;
+    ASSERT_TRUE(container.setValue<Enabled>(true));
+    ASSERT_TRUE(container.setValue<Address>(0x1234));
+    ASSERT_TRUE(container.setValue<Trim>(-3));
+    ASSERT_TRUE(container.setValue<Gain>(1.5f));
+    Container::ValueArray values;
+    container.copyValuesTo(values);
+
+    Serializer::Image image{};
+    Serializer::serialize(values, image);
+    // little endian bit stream, trim as offset to its min, 1.5f is 0x3FC00000
+    const Serializer::Image Expected = {0x69, 0x24, 0x04, 0x00, 0x00, 0xF8, 0x07};
+    EXPECT_EQ(image, Expected);
+
+    EXPECT_EQ(Serializer::deserialize(image), values);
+    for (size_t i = 0; i < EntryArray.size(); ++i)
+    {
+        EXPECT_EQ(Serializer::getRaw(image, i), Container::Layout::getRaw(values, i));
+    }
+}
+
+TEST(ValueFormat, compactExtremes)
+{
+    Container container;
+    ASSERT_TRUE(container.setValue<Address>(0xFFFF));
+    ASSERT_TRUE(container.setValue<Trim>(9));
+    ASSERT_TRUE(container.setValue<Gain>(-2.0f));
+    Container::ValueArray values;
+    container.copyValuesTo(values);
+
+    Serializer::Image image{};
+    Serializer::serialize(values, image);
+    Container other;
+    EXPECT_EQ(other.assignValues(Serializer::deserialize(image)), 0);
+    EXPECT_EQ(other, container);
+}
+
+TEST(ValueFormat, compactFieldsOutOfBounds)
+{
+    Container container;
+    ASSERT_TRUE(container.setValue<Address>(0x1234));
+    ASSERT_TRUE(container.setValue<Gain>(1.5f));
+    Container::ValueArray values;
+    container.copyValuesTo(values);
+    const Container::ValueArray Expected = values;
+
+    // below min, the offset to min has all bits set
+    constexpr auto TrimIndex = Container::getIndex<Trim>();
+    Container::Layout::setRaw(values, TrimIndex, Container::Layout::toRaw(TrimIndex, -6));
+    Serializer::Image image{};
+    Serializer::serialize(values, image);
+
+    // only the bits of trim are affected
+    for (size_t i = 0; i < EntryArray.size(); ++i)
+    {
+        if (i != TrimIndex)
+        {
+            EXPECT_EQ(Serializer::getRaw(image, i), Container::Layout::getRaw(Expected, i)) << i;
+        }
+    }
+}
+
+class CompactSettingsIOTest : public ::testing::Test
+{
+protected:
+    CountingFakeEeprom eeprom{};
+    Container settingsContainer{};
+    CompactIO settingsIo{eeprom, settingsContainer};
+
+    CompactIO::EepromContent readContent()
+    {
+        CompactIO::EepromContent content;
+        eeprom.read(CompactIO::MemoryOffset, reinterpret_cast<uint8_t *>(&content),
+                    sizeof(content));
+        return content;
+    }
+};
+
+TEST_F(CompactSettingsIOTest, roundTrip)
+{
+    EXPECT_FALSE(settingsIo.loadSettings());
+    ASSERT_TRUE(settingsContainer.setValue<Address>(0xBEEF));
+    ASSERT_TRUE(settingsContainer.setValue<Trim>(-5));
+    settingsIo.saveChangedSettings();
+
+    Container other;
+    CompactIO otherIo{eeprom, other};
+    EXPECT_TRUE(otherIo.loadSettings());
+    EXPECT_EQ(other, settingsContainer);
+
+    // unchanged values, nothing to write
+    const size_t BytesWritten = eeprom.bytesWritten;
+    settingsIo.saveSettings();
+    EXPECT_EQ(eeprom.bytesWritten, BytesWritten);
+}
+
+TEST_F(CompactSettingsIOTest, outOfRangeField)
+{
+    EXPECT_FALSE(settingsIo.loadSettings());
+
+    // trim has 4 bits for its 15 values, the field 15 is out of range
+    auto content = readContent();
+    content.settingsValues[2] |= 0x1E;
+    content.settingsValuesHash =
+        CompactIO::hashSettingsValues(content.settingsValues, content.generation);
+    eeprom.write(CompactIO::MemoryOffset, reinterpret_cast<uint8_t *>(&content), sizeof(content));
+
+    Container other;
+    ASSERT_TRUE(other.setValue<Trim>(3));
+    CompactIO otherIo{eeprom, other};
+    EXPECT_TRUE(otherIo.loadSettings());
+    EXPECT_EQ((other.getValue<Trim, int>()), 0);
+}
+
+TEST_F(CompactSettingsIOTest, littleEndianHeader)
+{
+    EXPECT_FALSE(settingsIo.loadSettings());
+    std::array<uint8_t, CompactIO::HeaderSize> header{};
+    eeprom.read(CompactIO::MemoryOffset, header.data(), header.size());
+
+    // fixed width fields, least significant byte first on every target
+    static_assert(CompactIO::HeaderSize == 2 * sizeof(uint64_t) + 2 * sizeof(uint32_t) +
+                                               2 * sizeof(uint16_t));
+    constexpr size_t MagicOffset = offsetof(CompactIO::EepromContent, magicString);
+    EXPECT_EQ(header[MagicOffset], 0x6F);
+    EXPECT_EQ(header[MagicOffset + 1], 0xCA);
+    EXPECT_EQ(header[MagicOffset + 2], 0x10);
+    EXPECT_EQ(header[MagicOffset + 3], 0x01);
+    constexpr size_t GenerationOffset = offsetof(CompactIO::EepromContent, generation);
+    EXPECT_EQ(header[GenerationOffset], 1);
+    EXPECT_EQ(header[GenerationOffset + 1], 0);
+    constexpr size_t CountOffset = offsetof(CompactIO::EepromContent, settingsEntryCount);
+    EXPECT_EQ(header[CountOffset], EntryArray.size());
+    EXPECT_EQ(header[CountOffset + 1], 0);
+
+    const uint64_t NamesHash = CompactIO::hashSettingsNames();
+    constexpr size_t HashOffset = offsetof(CompactIO::EepromContent, settingsNamesHash);
+    for (size_t i = 0; i < sizeof(NamesHash); ++i)
+    {
+        EXPECT_EQ(header[HashOffset + i], static_cast<uint8_t>(NamesHash >> (8 * i))) << i;
+    }
+}
+} // namespace
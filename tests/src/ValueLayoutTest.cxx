@@ -0,0 +1,143 @@
+#include "fake/FakeEeprom.hpp"
+#include "settings-manager/SettingsContainer.hpp"
+#include "settings-manager/SettingsIO.hpp"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+using namespace settings;
+
+namespace
+{
+constexpr std::string_view Flag1 = "flag1";
+constexpr std::string_view Gain = "gain";
+constexpr std::string_view Flag2 = "flag2";
+constexpr std::string_view Counter = "counter";
+constexpr std::string_view Flag3 = "flag3";
+
+constexpr int32_t CounterMax = std::numeric_limits<int32_t>::max();
+
+constexpr std::array EntryArray = {
+    SettingsEntry{true, Flag1},
+    SettingsEntry{-1.0f, 0.5f, 1.0f, Gain},
+    SettingsEntry{false, Flag2},
+    SettingsEntry::integer(-5, 16777217, CounterMax, Counter),
+    SettingsEntry{true, Flag3},
+};
+using Container = SettingsContainer<EntryArray.size(), EntryArray>;
+
+namespace TestLayoutChange
+{
+// same names, Flag3 became an integer
+constexpr std::array EntryArray = {
+    SettingsEntry{true, Flag1},
+    SettingsEntry{-1.0f, 0.5f, 1.0f, Gain},
+    SettingsEntry{false, Flag2},
+    SettingsEntry::integer(-5, 16777217, CounterMax, Counter),
+    SettingsEntry{0, 1, 1, Flag3, VariableType::integerType},
+};
+} // namespace TestLayoutChange
+using Layout = Container::Layout;
+
+constexpr size_t GainIndex = Container::getIndex<Gain>();
+constexpr size_t CounterIndex = Container::getIndex<Counter>();
+
+TEST(ValueLayout, placement)
+{
+    // real and integer own a word each, all booleans share the last one
+    static_assert(Layout::BooleanCount == 3);
+    static_assert(Layout::WordCount == 3);
+    static_assert(sizeof(Container::ValueArray) == 3 * sizeof(uint32_t));
+    static_assert(Layout::wordOf(GainIndex) == 0);
+    static_assert(Layout::wordOf(CounterIndex) == 1);
+    static_assert(Layout::wordOf(Container::getIndex<Flag1>()) == 2);
+    static_assert(Layout::wordOf(Container::getIndex<Flag3>()) == 2);
+
+    constexpr auto Defaults = Layout::createDefaultWords();
+    static_assert(Defaults[2] == 0b101);
+    static_assert(Defaults[1] == 16777217);
+    static_assert(Layout::decodeAs<VariableType::realType, float>(Defaults[0]) == 0.5f);
+}
+
+TEST(ValueLayout, integersAreExact)
+{
+    Container container;
+    // not representable as float
+    EXPECT_EQ((container.getValue<Counter, int32_t>()), 16777217);
+    EXPECT_TRUE(container.setValue<Counter>(CounterMax));
+    EXPECT_EQ((container.getValue<Counter, int32_t>()), CounterMax);
+    EXPECT_EQ(container.getValue<int64_t>(CounterIndex), CounterMax);
+
+    EXPECT_TRUE(container.setValue<Counter>(16777217));
+    EXPECT_TRUE(container.addToValue<Counter>(2));
+    EXPECT_EQ((container.getValue<Counter, int32_t>()), 16777219);
+    EXPECT_FALSE(container.addToValue<Counter>(CounterMax));
+    EXPECT_FALSE(container.setValue<Counter>(-6));
+    EXPECT_FALSE(container.setValue<Counter>(uint64_t{1} << 40));
+    EXPECT_EQ((container.getValue<Counter, int32_t>()), 16777219);
+
+    // floating point values are rounded
+    EXPECT_TRUE(container.setValue(Counter, 2.6f));
+    EXPECT_EQ(container.getValue<int32_t>(Counter), 3);
+    EXPECT_FLOAT_EQ(container.getValue(Counter), 3.0f);
+    EXPECT_TRUE(container.setValue(Counter, -5.4));
+    EXPECT_EQ(container.getValue<int32_t>(Counter), -5);
+    EXPECT_FALSE(container.setValue(Counter, -5.6));
+    EXPECT_FALSE(container.setValue(Counter, std::numeric_limits<float>::quiet_NaN()));
+}
+
+TEST(ValueLayout, packedBooleans)
+{
+    Container container;
+    EXPECT_TRUE((container.getValue<Flag1, bool>()));
+    EXPECT_FALSE((container.getValue<Flag2, bool>()));
+
+    EXPECT_TRUE(container.setValue<Flag2>(true));
+    EXPECT_TRUE(container.setValue<Flag1>(0));
+    EXPECT_FALSE(container.setValue<Flag3>(2));
+    EXPECT_FALSE((container.getValue<Flag1, bool>()));
+    EXPECT_TRUE((container.getValue<Flag2, bool>()));
+    EXPECT_TRUE((container.getValue<Flag3, bool>()));
+    EXPECT_FLOAT_EQ(container.getValue(Flag2), 1.0f);
+    EXPECT_EQ(container.getDirtyEntries().count(), 2);
+
+    Container::ValueArray values;
+    container.copyValuesTo(values);
+    EXPECT_EQ(values[2], 0b110);
+}
+
+TEST(ValueLayout, reals)
+{
+    Container container;
+    EXPECT_TRUE(container.setValue<Gain>(-0.25f));
+    EXPECT_FLOAT_EQ(container.getValue<Gain>(), -0.25f);
+    EXPECT_EQ((container.getValue<Gain, int>()), 0);
+    EXPECT_FALSE(container.setValue<Gain>(2));
+}
+
+TEST(ValueLayout, persisted)
+{
+    using IO = SettingsIO<EntryArray.size(), EntryArray, FakeEeprom>;
+    static_assert(sizeof(IO::EepromContent::settingsValues) == 3 * sizeof(uint32_t));
+
+    FakeEeprom eeprom;
+    Container container;
+    IO io{eeprom, container};
+    EXPECT_FALSE(io.loadSettings());
+    EXPECT_TRUE(container.setValue<Counter>(CounterMax - 1));
+    EXPECT_TRUE(container.setValue<Flag3>(false));
+    io.saveSettings();
+
+    Container loaded;
+    IO otherIo{eeprom, loaded};
+    EXPECT_TRUE(otherIo.loadSettings());
+    EXPECT_EQ(loaded, container);
+    EXPECT_EQ((loaded.getValue<Counter, int32_t>()), CounterMax - 1);
+
+    // the layout follows the types, so changing a type invalidates the content
+    EXPECT_NE(IO::hashSettingsNames(),
+              (SettingsIO<TestLayoutChange::EntryArray.size(), TestLayoutChange::EntryArray,
+                          FakeEeprom>::hashSettingsNames()));
+}
+} // namespace
@@ -0,0 +1,12 @@
+#include "TestSettings.hpp"
+#include "settings-manager/ImageMemory.hpp"
+#include "settings-manager/ImageTool.hpp"
+
+/// Image tool for the settings of the tests, a template for the tool of a firmware.
+using Memory = settings::ImageMemory<FakeEeprom::getSizeInBytes(), FakeEeprom::getPageSize()>;
+using IO = settings::SettingsIO<TestSettings::EntryArray.size(), TestSettings::EntryArray, Memory>;
+
+int main(int argc, char **argv)
+{
+    return settings::ImageTool<IO>{}.run(argc, argv);
+}